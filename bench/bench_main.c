@@ -0,0 +1,21 @@
+// Copyright 2022-2023, Offchain Labs, Inc.
+// For licensing, see https://github.com/OffchainLabs/stylus-sdk-c/blob/stylus/licenses/COPYRIGHT.md
+//
+// Entrypoint running a single microbenchmark, for both the wasm and the native build.
+//
+// input: case index (1 byte), iterations (4 bytes, big-endian)
+// output: none
+
+#include <stylus_entry.h>
+#include <bebi.h>
+#include "micro.h"
+
+ArbResult bench_main(uint8_t *args, size_t args_len) {
+    if (args_len != 5 || args[0] >= bench_cases_count) {
+        return (ArbResult) { .status = Failure, .output = NULL, .output_len = 0 };
+    }
+    bench_cases[args[0]].run(bebi_get_u32(args, 1));
+    return (ArbResult) { .status = Success, .output = NULL, .output_len = 0 };
+}
+
+ENTRYPOINT(bench_main);
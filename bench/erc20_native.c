@@ -0,0 +1,131 @@
+// Copyright 2022-2023, Offchain Labs, Inc.
+// For licensing, see https://github.com/OffchainLabs/stylus-sdk-c/blob/stylus/licenses/COPYRIGHT.md
+//
+// End-to-end erc20 scenarios, run natively through the simulator. Prints json:
+//     { "<scenario>": { "cycles_per_call": ..., "ns_per_call": ..., "last_call_hostio_ink": ...,
+//                       "last_call_hostios": {...} }, ... }
+// cycles and ns are averages over all calls of a scenario. Ink and hostio counts are those of
+// its last call only: the calls of a scenario make the same hostios.
+//
+// Setup: 0x01 is the first minter, mints to 0x03. Then each scenario repeats CALLS times:
+//  * add_minter: 0x01 adds a new minter
+//  * mint: 0x01 mints to 0x03
+//  * transfer: 0x03 transfers to 0x04
+//  * batch_transfer_16: 0x03 transfers to 16 recipients in one batchTransfer call
+// The calls are the same as in run.js, which measures the wasm.
+
+#include <stdio.h>
+#include <string.h>
+#include <stylus_sim.h>
+#include "timing.h"
+
+#define CALLS 10000
+
+static const uint8_t SEL_INIT[4] = { 0x19, 0xab, 0x45, 0x3c };
+static const uint8_t SEL_ADD_MINTER[4] = { 0x30, 0x52, 0xa8, 0xdb };
+static const uint8_t SEL_MINT[4] = { 0x40, 0xc1, 0x0f, 0x19 };
+static const uint8_t SEL_TRANSFER[4] = { 0xa9, 0x05, 0x9c, 0xbb };
+static const uint8_t SEL_BATCH_TRANSFER[4] = { 0x88, 0xd6, 0x95, 0xb2 };
+
+#define BATCH 16
+
+// large enough for batchTransfer(address[BATCH], uint256[BATCH])
+static uint8_t calldata[4 + 32 * (2 + 2 * (BATCH + 1))];
+
+// builds selector(address, [amount]) calldata, returns its length
+static size_t encode(const uint8_t *selector, uint32_t address, uint32_t amount, bool has_amount) {
+    memset(calldata, 0, sizeof(calldata));
+    memcpy(calldata, selector, 4);
+    bebi_set_u32(calldata, 4 + 28, address);
+    if (!has_amount) {
+        return 4 + 32;
+    }
+    bebi_set_u32(calldata, 4 + 60, amount);
+    return 4 + 64;
+}
+
+// builds batchTransfer calldata to addresses first..first+BATCH-1, each getting amount
+static size_t encode_batch(uint32_t first, uint32_t amount) {
+    memset(calldata, 0, sizeof(calldata));
+    memcpy(calldata, SEL_BATCH_TRANSFER, 4);
+    uint8_t *args = calldata + 4;
+    uint32_t to_offset = 64;
+    uint32_t values_offset = to_offset + 32 * (BATCH + 1);
+    bebi_set_u32(args, 28, to_offset);
+    bebi_set_u32(args, 60, values_offset);
+    bebi_set_u32(args, to_offset + 28, BATCH);
+    bebi_set_u32(args, values_offset + 28, BATCH);
+    for (uint32_t i = 0; i < BATCH; i++) {
+        bebi_set_u32(args, to_offset + 32 * (i + 1) + 28, first + i);
+        bebi_set_u32(args, values_offset + 32 * (i + 1) + 28, amount);
+    }
+    return 4 + values_offset + 32 * (BATCH + 1);
+}
+
+static void set_sender(uint32_t address) {
+    memset(sim_context.msg_sender, 0, 20);
+    bebi_set_u32(sim_context.msg_sender, 16, address);
+}
+
+static int call(size_t len) {
+    const uint8_t *result;
+    size_t result_len;
+    return sim_call(calldata, len, &result, &result_len);
+}
+
+static const char *sep = "";
+
+static void report(const char *name, bench_time elapsed) {
+    const sim_stats *stats = sim_last_stats();
+    printf("%s  \"%s\": { \"cycles_per_call\": %.2f, \"ns_per_call\": %.2f, \"last_call_hostio_ink\": %llu, \"last_call_hostios\": {",
+           sep, name, (double)elapsed.cycles / CALLS, (double)elapsed.ns / CALLS,
+           (unsigned long long)stats->ink_used);
+    const char *inner = "";
+    for (int h = 0; h < SIM_HOSTIO_COUNT; h++) {
+        if (stats->hostio_calls[h]) {
+            printf("%s \"%s\": %llu", inner, sim_hostio_name(h), (unsigned long long)stats->hostio_calls[h]);
+            inner = ",";
+        }
+    }
+    printf(" } }");
+    sep = ",\n";
+}
+
+int main() {
+    sim_reset();
+    set_sender(1);
+    if (call(encode(SEL_INIT, 1, 0, false)) != 0 ||
+        call(encode(SEL_MINT, 3, 1000000000, true)) != 0) {
+        fprintf(stderr, "erc20 setup failed\n");
+        return 1;
+    }
+    printf("{\n");
+
+    bench_time start = bench_now();
+    for (uint32_t i = 0; i < CALLS; i++) {
+        call(encode(SEL_ADD_MINTER, 0x100 + i, 0, false));
+    }
+    report("add_minter", bench_elapsed(start));
+
+    start = bench_now();
+    for (uint32_t i = 0; i < CALLS; i++) {
+        call(encode(SEL_MINT, 3, 1000, true));
+    }
+    report("mint", bench_elapsed(start));
+
+    set_sender(3);
+    start = bench_now();
+    for (uint32_t i = 0; i < CALLS; i++) {
+        call(encode(SEL_TRANSFER, 4, 10, true));
+    }
+    report("transfer", bench_elapsed(start));
+
+    start = bench_now();
+    for (uint32_t i = 0; i < CALLS; i++) {
+        call(encode_batch(0x10, 10));
+    }
+    report("batch_transfer_16", bench_elapsed(start));
+
+    printf("\n}\n");
+    return 0;
+}
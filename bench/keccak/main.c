@@ -0,0 +1,65 @@
+// Copyright 2022-2023, Offchain Labs, Inc.
+// For licensing, see https://github.com/OffchainLabs/stylus-sdk-c/blob/stylus/licenses/COPYRIGHT.md
+//
+// Measures the ink cost of keccak256 through the native_keccak256 hostio, and through
+// the in-wasm implementation in keccak.c, for a list of input sizes.
+//
+// input: a list of 2-byte big-endian input sizes (each up to MAX_INPUT)
+// output: for each size, 24 bytes: the size, native ink and wasm ink as 8-byte big-endian values
+//
+// The ink cost of measuring (a pair of evm_ink_left calls) is subtracted from both.
+// Use the results to pick KECCAK256_WASM_BELOW (see keccak.h).
+
+#include <stylus_entry.h>
+#include <keccak.h>
+#include <bebi.h>
+
+#define MAX_INPUT 1024
+#define MAX_SIZES 64
+
+static uint8_t input[MAX_INPUT];
+static uint8_t output[MAX_SIZES * 24];
+
+static uint64_t measure_overhead() {
+    uint64_t before = evm_ink_left();
+    uint64_t after = evm_ink_left();
+    return before - after;
+}
+
+ArbResult bench_main(uint8_t *args, size_t args_len) {
+    size_t count = args_len / 2;
+    if (args_len % 2 != 0 || count > MAX_SIZES) {
+        return (ArbResult) { .status = Failure, .output = NULL, .output_len = 0 };
+    }
+    for (size_t i = 0; i < MAX_INPUT; i++) {
+        input[i] = (uint8_t)i;
+    }
+    uint64_t overhead = measure_overhead();
+    bebi32 hash;
+
+    for (size_t i = 0; i < count; i++) {
+        uint16_t size = bebi_get_u16(args, 2 * i);
+        if (size > MAX_INPUT) {
+            return (ArbResult) { .status = Failure, .output = NULL, .output_len = 0 };
+        }
+        uint64_t before = evm_ink_left();
+        native_keccak256(input, size, hash);
+        uint64_t native_ink = before - evm_ink_left() - overhead;
+
+        before = evm_ink_left();
+        keccak256_wasm(input, size, hash);
+        uint64_t wasm_ink = before - evm_ink_left() - overhead;
+
+        bebi_set_u64(output, 24 * i, size);
+        bebi_set_u64(output, 24 * i + 8, native_ink);
+        bebi_set_u64(output, 24 * i + 16, wasm_ink);
+    }
+
+    return (ArbResult) {
+        .status = Success,
+        .output = output,
+        .output_len = 24 * count,
+    };
+}
+
+ENTRYPOINT(bench_main);
@@ -0,0 +1,179 @@
+#include <string.h>
+#include <stdlib.h>
+#include <bebi.h>
+#include <storage.h>
+#include <keccak.h>
+#include "micro.h"
+
+// siphash impl from examples/siphash/siphash.c
+extern uint64_t siphash24(const void *src, unsigned long len, const uint8_t key[16]);
+
+// results are folded into the sink so no kernel is optimized away
+volatile uint64_t bench_sink;
+
+static uint8_t input[256];
+static uint8_t output[256];
+
+static void init_operands(bebi32 a, bebi32 b) {
+    for (int i = 0; i < 32; i++) {
+        a[i] = (uint8_t)(i * 7 + 1);
+        b[i] = (uint8_t)(i * 13 + 5);
+    }
+}
+
+static void bench_bebi32_add(uint32_t iterations) {
+    bebi32 a, b;
+    init_operands(a, b);
+    for (uint32_t i = 0; i < iterations; i++) {
+        bebi32_add(a, b);
+    }
+    bench_sink += a[31];
+}
+
+static void bench_bebi32_sub(uint32_t iterations) {
+    bebi32 a, b;
+    init_operands(a, b);
+    for (uint32_t i = 0; i < iterations; i++) {
+        bebi32_sub(a, b);
+    }
+    bench_sink += a[31];
+}
+
+static void bench_bebi32_cmp(uint32_t iterations) {
+    bebi32 a, b;
+    init_operands(a, b);
+    memcpy(b, a, 32);
+    int64_t acc = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        b[31] = (uint8_t)i;
+        acc += bebi32_cmp(a, b);
+    }
+    bench_sink += acc;
+}
+
+static void bench_bebi32_set_get_u8(uint32_t iterations) {
+    bebi32 a;
+    uint64_t acc = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        bebi32_set_u8(a, (uint8_t)(i + acc));
+        acc += bebi_get_u8(a, 31);
+    }
+    bench_sink += acc;
+}
+
+static void bench_bebi32_set_get_u16(uint32_t iterations) {
+    bebi32 a;
+    uint64_t acc = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        bebi32_set_u16(a, (uint16_t)(i + acc));
+        acc += bebi32_get_u16(a);
+    }
+    bench_sink += acc;
+}
+
+static void bench_bebi32_set_get_u32(uint32_t iterations) {
+    bebi32 a;
+    uint64_t acc = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        bebi32_set_u32(a, (uint32_t)(i + acc));
+        acc += bebi32_get_u32(a);
+    }
+    bench_sink += acc;
+}
+
+static void bench_bebi32_set_get_u64(uint32_t iterations) {
+    bebi32 a;
+    uint64_t acc = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        bebi32_set_u64(a, i + acc);
+        acc += bebi32_get_u64(a);
+    }
+    bench_sink += acc;
+}
+
+static void bench_map_slot(uint32_t iterations) {
+    bebi32 base = {0};
+    bebi32 key = {0};
+    bebi32 slot;
+    for (uint32_t i = 0; i < iterations; i++) {
+        bebi32_set_u32(key, i);
+        map_slot(base, key, 32, slot);
+        base[31] ^= slot[31];
+    }
+    bench_sink += base[31];
+}
+
+static void bench_array_slot_offset(uint32_t iterations) {
+    bebi32 base;
+    bebi32 slot;
+    size_t offset;
+    init_operands(base, slot);
+    uint64_t acc = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        array_slot_offset(base, 8, i, slot, &offset);
+        acc += slot[31] + offset;
+    }
+    bench_sink += acc;
+}
+
+static void bench_malloc(uint32_t iterations) {
+    uint64_t acc = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        acc += (size_t)malloc(32);
+    }
+    bench_sink += acc;
+}
+
+static void bench_memcpy(uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        input[i % sizeof(input)] = (uint8_t)i;
+        memcpy(output, input, sizeof(input));
+    }
+    bench_sink += output[0];
+}
+
+static void bench_strncpy(uint32_t iterations) {
+    memset(input, 'a', 64);
+    input[64] = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        input[0] = 'a' + (i % 26);
+        strncpy((char *)output, (const char *)input, 32);
+    }
+    bench_sink += output[0];
+}
+
+static void bench_siphash24(uint32_t iterations) {
+    uint8_t key[16] = {0};
+    uint64_t acc = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        key[0] = (uint8_t)i;
+        acc += siphash24(input, 64, key);
+    }
+    bench_sink += acc;
+}
+
+static void bench_keccak256_wasm(uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        keccak256_wasm(output, 64, output);
+    }
+    bench_sink += output[0];
+}
+
+const bench_case bench_cases[] = {
+    {"bebi32_add", bench_bebi32_add, true},
+    {"bebi32_sub", bench_bebi32_sub, true},
+    {"bebi32_cmp", bench_bebi32_cmp, true},
+    {"bebi32_set_get_u8", bench_bebi32_set_get_u8, true},
+    {"bebi32_set_get_u16", bench_bebi32_set_get_u16, true},
+    {"bebi32_set_get_u32", bench_bebi32_set_get_u32, true},
+    {"bebi32_set_get_u64", bench_bebi32_set_get_u64, true},
+    {"map_slot", bench_map_slot, true},
+    {"array_slot_offset", bench_array_slot_offset, true},
+    {"malloc", bench_malloc, false},
+    {"memcpy", bench_memcpy, false},
+    {"strncpy", bench_strncpy, false},
+    {"siphash24", bench_siphash24, true},
+    {"keccak256_wasm", bench_keccak256_wasm, true},
+};
+
+const size_t bench_cases_count = sizeof(bench_cases) / sizeof(bench_cases[0]);
@@ -0,0 +1,24 @@
+#ifndef __BENCH_MICRO_H
+#define __BENCH_MICRO_H
+
+/**
+ * Microbenchmark kernels, shared by the native and wasm builds.
+ * Each kernel runs its operation "iterations" times, chaining results so the
+ * compiler can't hoist or drop the work.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct bench_case {
+    const char *name;
+    void (*run)(uint32_t iterations);
+    // false for kernels that resolve to the host's libc when built natively
+    bool native;
+} bench_case;
+
+extern const bench_case bench_cases[];
+extern const size_t bench_cases_count;
+
+#endif // __BENCH_MICRO_H
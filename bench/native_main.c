@@ -0,0 +1,65 @@
+// Copyright 2022-2023, Offchain Labs, Inc.
+// For licensing, see https://github.com/OffchainLabs/stylus-sdk-c/blob/stylus/licenses/COPYRIGHT.md
+//
+// Runs the microbenchmarks natively, through the simulator, and prints json:
+//     { "<case>": { "cycles_per_op": ..., "ns_per_op": ... }, ... }
+//
+// Each case runs with N and 2N iterations, and the difference is divided by N, so the cost
+// of sim_call and the entrypoint cancel out. Each of N and 2N keeps its fastest of REPEATS
+// runs, and the difference of those two minimums is reported: taking the minimum of the
+// differences instead would favor runs where noise slowed down the N run.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stylus_sim.h>
+#include "micro.h"
+#include "timing.h"
+
+#define ITERATIONS 200000
+#define REPEATS 5
+
+static bench_time run_case(uint8_t idx, uint32_t iterations) {
+    uint8_t args[5] = { idx };
+    bebi_set_u32(args, 1, iterations);
+    const uint8_t *result;
+    size_t result_len;
+    bench_time start = bench_now();
+    if (sim_call(args, sizeof(args), &result, &result_len) != 0) {
+        fprintf(stderr, "%s failed\n", bench_cases[idx].name);
+    }
+    return bench_elapsed(start);
+}
+
+int main() {
+    sim_reset();
+    sim_context.ink_limit = UINT64_MAX;
+
+    printf("{\n");
+    const char *sep = "";
+    for (size_t idx = 0; idx < bench_cases_count; idx++) {
+        if (!bench_cases[idx].native) {
+            continue;
+        }
+        bench_time best_once = { 0 }, best_twice = { 0 };
+        bool measured = false;
+        for (int r = 0; r < REPEATS; r++) {
+            bench_time once = run_case(idx, ITERATIONS);
+            bench_time twice = run_case(idx, 2 * ITERATIONS);
+            if (!measured || once.ns < best_once.ns) {
+                best_once = once;
+            }
+            if (!measured || twice.ns < best_twice.ns) {
+                best_twice = twice;
+            }
+            measured = true;
+        }
+        double best_cycles = ((double)best_twice.cycles - (double)best_once.cycles) / ITERATIONS;
+        double best_ns = ((double)best_twice.ns - (double)best_once.ns) / ITERATIONS;
+        printf("%s  \"%s\": { \"cycles_per_op\": %.2f, \"ns_per_op\": %.2f }",
+               sep, bench_cases[idx].name, best_cycles, best_ns);
+        sep = ",\n";
+    }
+    printf("\n}\n");
+    return 0;
+}
@@ -0,0 +1,177 @@
+#!/usr/bin/env node
+// Copyright 2022-2023, Offchain Labs, Inc.
+// For licensing, see https://github.com/OffchainLabs/stylus-sdk-c/blob/stylus/licenses/COPYRIGHT.md
+//
+// Runs the wasm side of the benchmark suite in the local harness (../tools/stylus_harness.js),
+// merges it with the native results, and writes one json report:
+//     {
+//       "micro": { "<case>": { "native_cycles_per_op", "native_ns_per_op",
+//                              "wasm_instructions_per_op", "hostios_per_op" } },
+//       "erc20": { "<scenario>": { "native_cycles_per_call", "native_ns_per_call",
+//                                  "native_last_call_hostio_ink",
+//                                  "wasm_instructions", "hostios" } }
+//     }
+//
+// usage:
+//     node run.js [--micro-wasm f] [--erc20-wasm f] [--native-micro f] [--native-erc20 f] [--out f]
+//
+// Missing inputs are skipped with a warning, so either side can run on its own.
+
+'use strict';
+
+const fs = require('fs');
+const { Harness, hexToBuffer } = require('../tools/stylus_harness');
+
+// must match micro.c
+const CASES = [
+    'bebi32_add', 'bebi32_sub', 'bebi32_cmp',
+    'bebi32_set_get_u8', 'bebi32_set_get_u16', 'bebi32_set_get_u32', 'bebi32_set_get_u64',
+    'map_slot', 'array_slot_offset', 'malloc', 'memcpy', 'strncpy', 'siphash24', 'keccak256_wasm',
+];
+const ITERATIONS = 1000;
+
+function parseArgs(argv) {
+    const options = {
+        'micro-wasm': 'build/bench.wasm',
+        'erc20-wasm': '../examples/erc20/erc20.wasm',
+        'native-micro': 'build/native_micro.json',
+        'native-erc20': 'build/native_erc20.json',
+        out: 'build/results.json',
+    };
+    for (let i = 0; i < argv.length; i += 2) {
+        const name = argv[i].replace(/^--/, '');
+        if (!(name in options) || i + 1 >= argv.length) {
+            throw new Error(`bad option ${argv[i]}`);
+        }
+        options[name] = argv[i + 1];
+    }
+    return options;
+}
+
+function readOptional(path, what) {
+    if (!fs.existsSync(path)) {
+        process.stderr.write(`skipping ${what}: ${path} not found\n`);
+        return null;
+    }
+    return fs.readFileSync(path);
+}
+
+function microArgs(idx, iterations) {
+    const args = Buffer.alloc(5);
+    args[0] = idx;
+    args.writeUInt32BE(iterations, 1);
+    return args;
+}
+
+// per-op cost: the difference between N and 2N iterations, so fixed costs cancel out
+function runMicro(wasmBytes, results) {
+    const harness = new Harness(wasmBytes);
+    CASES.forEach((name, idx) => {
+        const once = harness.call(microArgs(idx, ITERATIONS));
+        const twice = harness.call(microArgs(idx, 2 * ITERATIONS));
+        if (once.status !== 0 || twice.status !== 0) {
+            throw new Error(`${name} failed`);
+        }
+        const hostios = {};
+        for (const [hostio, count] of Object.entries(twice.hostios)) {
+            const perOp = (count - (once.hostios[hostio] || 0)) / ITERATIONS;
+            if (perOp !== 0) {
+                hostios[hostio] = perOp;
+            }
+        }
+        const entry = results[name] || (results[name] = {});
+        entry.wasm_instructions_per_op = (twice.instructions - once.instructions) / ITERATIONS;
+        entry.hostios_per_op = hostios;
+    });
+}
+
+function word(value) {
+    return hexToBuffer(value.toString(16), 32);
+}
+
+function erc20Call(selector, address, amount) {
+    const parts = [Buffer.from(selector, 'hex'), word(address)];
+    if (amount !== undefined) {
+        parts.push(word(amount));
+    }
+    return Buffer.concat(parts);
+}
+
+// batchTransfer(address[], uint256[]) to addresses first..first+count-1, each getting amount
+function erc20BatchCall(first, count, amount) {
+    const to = [];
+    const values = [];
+    for (let i = 0; i < count; i++) {
+        to.push(word(first + i));
+        values.push(word(amount));
+    }
+    return Buffer.concat([Buffer.from('88d695b2', 'hex'), word(64), word(64 + 32 * (count + 1)),
+        word(count), ...to, word(count), ...values]);
+}
+
+// same setup and calls as erc20_native.c
+function runErc20(wasmBytes, results) {
+    const harness = new Harness(wasmBytes);
+    const address = (id) => '0x' + id.toString(16);
+    const setup = [
+        harness.call(erc20Call('19ab453c', 1), { sender: address(1) }),
+        harness.call(erc20Call('40c10f19', 3, 1000000000), { sender: address(1) }),
+    ];
+    if (setup.some((report) => report.status !== 0)) {
+        throw new Error('erc20 setup failed');
+    }
+    const scenarios = {
+        add_minter: harness.call(erc20Call('3052a8db', 0x100), { sender: address(1) }),
+        mint: harness.call(erc20Call('40c10f19', 3, 1000), { sender: address(1) }),
+        transfer: harness.call(erc20Call('a9059cbb', 4, 10), { sender: address(3) }),
+        batch_transfer_16: harness.call(erc20BatchCall(0x10, 16, 10), { sender: address(3) }),
+    };
+    for (const [name, report] of Object.entries(scenarios)) {
+        if (report.status !== 0) {
+            throw new Error(`erc20 ${name} failed`);
+        }
+        const entry = results[name] || (results[name] = {});
+        entry.wasm_instructions = report.instructions;
+        entry.hostios = report.hostios;
+    }
+}
+
+function mergeNative(native, results) {
+    for (const [name, values] of Object.entries(native)) {
+        const entry = results[name] || (results[name] = {});
+        for (const [key, value] of Object.entries(values)) {
+            if (key === 'last_call_hostios') {
+                entry.hostios = entry.hostios || value;
+            } else {
+                entry[`native_${key}`] = value;
+            }
+        }
+    }
+}
+
+function main() {
+    const options = parseArgs(process.argv.slice(2));
+    const report = { micro: {}, erc20: {} };
+
+    const nativeMicro = readOptional(options['native-micro'], 'native microbenchmarks');
+    if (nativeMicro) {
+        mergeNative(JSON.parse(nativeMicro), report.micro);
+    }
+    const nativeErc20 = readOptional(options['native-erc20'], 'native erc20');
+    if (nativeErc20) {
+        mergeNative(JSON.parse(nativeErc20), report.erc20);
+    }
+    const microWasm = readOptional(options['micro-wasm'], 'wasm microbenchmarks');
+    if (microWasm) {
+        runMicro(microWasm, report.micro);
+    }
+    const erc20Wasm = readOptional(options['erc20-wasm'], 'wasm erc20');
+    if (erc20Wasm) {
+        runErc20(erc20Wasm, report.erc20);
+    }
+
+    fs.writeFileSync(options.out, JSON.stringify(report, null, 2) + '\n');
+    process.stdout.write(`wrote ${options.out}\n`);
+}
+
+main();
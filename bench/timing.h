@@ -0,0 +1,34 @@
+#ifndef __BENCH_TIMING_H
+#define __BENCH_TIMING_H
+
+/**
+ * Native timers for the benchmark drivers: cycles (x86 tsc, 0 elsewhere) and nanoseconds.
+ */
+
+#include <stdint.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+typedef struct bench_time {
+    uint64_t cycles;
+    uint64_t ns;
+} bench_time;
+
+static inline bench_time bench_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    bench_time now = { .cycles = 0, .ns = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec };
+#if defined(__x86_64__) || defined(__i386__)
+    now.cycles = __rdtsc();
+#endif
+    return now;
+}
+
+static inline bench_time bench_elapsed(bench_time start) {
+    bench_time now = bench_now();
+    return (bench_time) { .cycles = now.cycles - start.cycles, .ns = now.ns - start.ns };
+}
+
+#endif // __BENCH_TIMING_H
@@ -27,7 +27,7 @@ contract Equivalent {
     bool  private initialized;
 
     // array of minters
-    // The array could hold blank values when removing a minter
+    // Removing a minter moves the last one into its place
     // slot 0 is always empty
     address[] public minters;
 
@@ -38,6 +38,9 @@ contract Equivalent {
     // also used to check if an address is a minter
     mapping(address minter => uint64) public minter_idx;
 
+    // allowances given by each account to each spender
+    mapping(address account => mapping(address spender => uint256)) private _allowances;
+
 
     // Standard pure functions of ERC20
     function name() public pure returns (string memory) {
@@ -78,6 +81,26 @@ contract Equivalent {
         return true;
     }
 
+    // move values[i] tokens from message sender to to[i], for all i
+    function batchTransfer(address[] calldata to, uint256[] calldata values) public returns (bool) {
+        require(to.length == values.length, "length mismatch");
+        require(to.length <= 64, "too many recipients");
+        uint256 total = 0;
+        for (uint256 i = 0; i < values.length; i++) {
+            total += values[i];
+        }
+        uint256 current_source = _balances[msg.sender];
+        // check if sender has enough balance for all transfers
+        if (current_source < total) {
+            return false;
+        }
+        _balances[msg.sender] = current_source - total;
+        for (uint256 i = 0; i < to.length; i++) {
+            _balances[to[i]] += values[i];
+        }
+        return true;
+    }
+
     /**
      * Minters
      * 
@@ -85,7 +108,7 @@ contract Equivalent {
      * Each minter may mint tokens, add or remove other minters
      *
      * Minters are kept in two databases: an array of all minters
-     * (may contain blanks), and a map from minter to it's index
+     * (without holes), and a map from minter to it's index
      * in the array. Index 0 is always blank so index 0 in the map
      * is used to signify an address that's not a minter.
      */
@@ -94,18 +117,17 @@ contract Equivalent {
     function push_minter(address minter) internal {
         uint64 index = uint64(minters.length);
         minters.push(minter);
-        // address 0 is never marked "minter"
-        if (uint160(minter) != 0) {
-            minter_idx[minter] = index;
-        }
+        minter_idx[minter] = index;
     }
 
     // set the first minter
     function init(address first_minter) public {
         // revert with reason string
         require(!initialized, "already initialized");
+        // address 0 is never a minter
+        require(uint160(first_minter) != 0);
         // first blank entry reserves index 0 for non-minters
-        push_minter(address(uint160(0)));
+        minters.push(address(uint160(0)));
         // push the first minter
         push_minter(first_minter);
         // set minters_current and initialized
@@ -121,20 +143,31 @@ contract Equivalent {
     // add a new minter
     function add_minter(address new_minter) public {
         require(from_minter(), "must be aminter");
+        require(uint160(new_minter) != 0);
+        // adding an existing minter changes nothing
+        if (minter_idx[new_minter] != 0) {
+            return;
+        }
         minters_current+=1;
         push_minter(new_minter);
     }
 
     // remove minter
-    // array entry is replaced with blank
+    // the last minter in the array takes its index, and the array is popped
     // minter_idx map entry is removed
     function remove_minter(address old_minter) public {
         require(from_minter(), "must be aminter");
         uint64 old_idx = minter_idx[old_minter];
         require(old_idx!=0, "remove: not minter");
-        minter_idx[old_minter];
+        uint64 last_idx = uint64(minters.length - 1);
+        if (old_idx != last_idx) {
+            address last_minter = minters[last_idx];
+            minters[old_idx] = last_minter;
+            minter_idx[last_minter] = old_idx;
+        }
+        minters.pop();
+        delete minter_idx[old_minter];
         minters_current-=1;
-        minters[old_idx] = address(uint160(0));
     }
 
     // mint new tokens for an account
@@ -145,10 +178,37 @@ contract Equivalent {
         _balances[account] += value;
     }
 
+    // standard ERC20: a read accessor to the allowances map
+    function allowance(address owner, address spender) public view returns (uint256) {
+        return _allowances[owner][spender];
+    }
+
+    // standard ERC20: allow spender to transfer up to value of the sender's tokens
+    function approve(address spender, uint256 value) public returns (bool) {
+        _allowances[msg.sender][spender] = value;
+        return true;
+    }
+
+    // standard ERC20: move "value" tokens from "from" to "to", using the sender's allowance
+    function transferFrom(address from, address to, uint256 value) public returns (bool) {
+        uint256 current_allowance = _allowances[from][msg.sender];
+        require(current_allowance >= value, "insufficient allowance");
+        uint256 current_source = _balances[from];
+        // check if source has enough balance
+        if (current_source < value) {
+            return false;
+        }
+        uint256 current_dest = _balances[to];
+        require(current_dest + value > current_dest, "overflow");
+        if (current_allowance != type(uint256).max) {
+            _allowances[from][msg.sender] = current_allowance - value;
+        }
+        _balances[from] = current_source - value;
+        _balances[to] = current_dest + value;
+        return true;
+    }
+
     // TODO: complete the ERC20 interface
-    // function allowance(address owner, address spender) public view virtual returns (uint256);
-    // function approve(address spender, uint256 value) public virtual returns (bool);
-    // function transferFrom(address from, address to, uint256 value) public virtual returns (bool);
     // function increaseAllowance(address spender, uint256 addedValue) public virtual returns (bool);
     // function decreaseAllowance(address spender, uint256 requestedDecrease) public virtual returns (bool);
 }
\ No newline at end of file
@@ -81,6 +81,12 @@ abstract contract ERC20 {
      */
     mapping(address spender => uint64) public minter_idx;
 
+    /**
+     * for nested maps, keys are hashed in turn starting from the outermost map.
+     * map_slot_path in storage.h resolves the whole chain in one call.
+     */
+    mapping(address account => mapping(address spender => uint256)) private _allowances;
+
 
     /**
      * PART II - functions
@@ -137,14 +143,22 @@ abstract contract ERC20 {
 
     function transfer(address to, uint256 value) public virtual returns (bool);
 
+    /**
+     * dynamic arrays are not decoded by the generated code either: input holds the abi
+     * encoding of both arrays (two offsets, then each array's length and elements).
+     * At most BATCH_MAX (64) recipients, which the implementation keeps on the stack.
+     */
+    function batchTransfer(address[] calldata to, uint256[] calldata values) public virtual returns (bool);
+
     function init(address first_minter) public virtual;
     function add_minter(address new_minter) public virtual;
     function remove_minter(address old_minter) public virtual;
 
+    function allowance(address owner, address spender) public view virtual returns (uint256);
+    function approve(address spender, uint256 value) public virtual returns (bool);
+    function transferFrom(address from, address to, uint256 value) public virtual returns (bool);
+
     // TODO: complete the ERC20 interface
-    // function allowance(address owner, address spender) public view virtual returns (uint256);
-    // function approve(address spender, uint256 value) public virtual returns (bool);
-    // function transferFrom(address from, address to, uint256 value) public virtual returns (bool);
     // function increaseAllowance(address spender, uint256 addedValue) public virtual returns (bool);
     // function decreaseAllowance(address spender, uint256 requestedDecrease) public virtual returns (bool);
 }
\ No newline at end of file
@@ -6,6 +6,10 @@
 #include <stdbool.h>
 #include <stylus_debug.h>
 #include <stylus_utils.h>
+#include <stylus_profile.h>
+#include <batch.h>
+#include <packed.h>
+#include <enumerable_set.h>
 
 /**
  * Implementation of the C ERC20-style contract.
@@ -45,7 +49,7 @@
 uint8_t buf_out[32];
 
 // succeed and return a bebi32
-ArbResult inline _success_bebi32(bebi32 const retval) {
+static inline ArbResult _success_bebi32(bebi32 const retval) {
     ArbResult res = {Success, retval , 32};
     return res;
 }
@@ -57,7 +61,7 @@ ArbResult inline _success_bebi32(bebi32 const retval) {
 // initialized and minters_current are in the same slot.
 // We access both these "short" values in the same function to remain in control of
 // the number of underline SLOAD/SSTORE operations
-void inline load_shorts(const void *storage, uint64_t *minters_current_out, bool *initialized_out) {
+static inline void load_shorts(const void *storage, uint64_t *minters_current_out, bool *initialized_out) {
     bebi32 storage_slot = STORAGE_SLOT_minters_current;
     bebi32 buf;
     storage_load(storage, storage_slot, buf);
@@ -73,7 +77,7 @@ void inline load_shorts(const void *storage, uint64_t *minters_current_out, bool
 }
 
 // always initialized==1 when storing
-void inline store_shorts(void *storage, uint64_t minters_current) {
+static inline void store_shorts(void *storage, uint64_t minters_current) {
     bebi32 storage_slot = STORAGE_SLOT_minters_current;
     bebi32 buf;
     bebi_set_u64(buf, STORAGE_END_OFFSET_minters_current - sizeof(uint64_t), minters_current);
@@ -93,6 +97,32 @@ void balance_slot(bebi32 const account, bebi32 slot_out) {
     map_slot(base, account, 32, slot_out);    
 }
 
+// calculate slot for allowances map of an account and a spender
+void allowance_slot(bebi32 const account, bebi32 const spender, bebi32 slot_out) {
+    bebi32 base = STORAGE_SLOT__allowances;
+    uint8_t const *keys[2] = {account, spender};
+    map_slot_path(base, keys, 2, slot_out);
+}
+
+// locate the elements of the dynamic array whose offset is in head word "head_idx" of input
+// (abi: the offset points to a length word, followed by the 32-byte elements)
+static int _abi_array(uint8_t const *input, size_t len, size_t head_idx, uint8_t const **data_out, size_t *count_out) {
+    if (len < 32 * (head_idx + 1) || !bebi32_is_u32(input + 32 * head_idx)) {
+        return -1;
+    }
+    uint32_t offset = bebi32_get_u32(input + 32 * head_idx);
+    if (offset > len - 32 || !bebi32_is_u32(input + offset)) {
+        return -1;
+    }
+    uint32_t count = bebi32_get_u32(input + offset);
+    if (count > (len - offset - 32) / 32) {
+        return -1;
+    }
+    *data_out = input + offset + 32;
+    *count_out = count;
+    return 0;
+}
+
 // get index of a minter from minter_idx map
 uint64_t _minter_idx(const void *storage, bebi32 const minter) {
     bebi32 slot;
@@ -110,8 +140,45 @@ uint64_t _minter_idx(const void *storage, bebi32 const minter) {
  * and/or have comparable implementation in equiv.sol
  */
 
+/**
+ * Packed calls
+ *
+ * Input that matches no selector is decoded as a packed call (see packed.h):
+ * a method byte, then fields without abi padding. A packed transfer is
+ * 0x00, the 20-byte destination, then the amount as a length byte and its
+ * significant bytes: 30 bytes for 10**18 tokens, instead of 68.
+ */
+
+#define PACKED_TRANSFER 0
+
+static ArbResult _transfer(void *storage, uint8_t const *dest, uint8_t const *amount);
+
+// packed transfer: address, uint
+static ArbResult packed_transfer(void *storage, packed_reader *args) {
+    bebi32 dest;
+    bebi32 amount;
+    packed_read_address(args, dest);
+    packed_read_uint(args, amount);
+    if (packed_end(args) != 0) {
+        return _return_nodata(Failure);
+    }
+    return _transfer(storage, dest, amount);
+}
+
+static const packed_handler packed_handlers[] = {
+    [PACKED_TRANSFER] = packed_transfer,
+};
+
 // the default function is called if input doesn't match any selector
 ArbResult default_func(void *storage, uint8_t *input, size_t len, bebi32 value) {
+    // the token takes no ether: packed calls are not payable either, so value would be locked
+    if (!bebi32_is_zero(value)) {
+        return _return_nodata(Failure);
+    }
+    if (len > 0 && input[0] < sizeof(packed_handlers) / sizeof(packed_handlers[0])) {
+        return packed_dispatch(storage, packed_handlers, sizeof(packed_handlers) / sizeof(packed_handlers[0]),
+                               input, len);
+    }
     // This will cause a revert with a reason strong, which can help debug
     return _return_short_string(Failure, "not supported");
 }
@@ -169,6 +236,49 @@ ArbResult balanceOf(const void *storage, uint8_t *input, size_t len) { // balanc
     return _success_bebi32(buf_out);    
 }
 
+// move "amount" tokens from message sender to "dest" (a padded address)
+// shared by the abi (transfer) and packed (packed_transfer) entrypoints
+static ArbResult _transfer(void *storage, uint8_t const *dest, uint8_t const *amount) {
+    // read message sender
+    bebi32 sender;
+    msg_sender_padded(sender);
+    // calculate the storage slot for sender's balance, and read it
+    // (build with -DSTYLUS_PROFILE to print the ink used, see stylus_profile.h)
+    PROFILE_BEGIN(transfer_sender_balance);
+    bebi32 balance_slot_buf;
+    balance_slot(sender, balance_slot_buf);
+    bebi32 balance_buf;
+    storage_load(storage, balance_slot_buf, balance_buf);
+    PROFILE_END(transfer_sender_balance);
+    // check if sender has enough balance
+    if (bebi32_cmp(balance_buf, amount) < 0) {
+        // return false
+        // notice we return a Success here because we do not revert
+        bebi32_set_u8(buf_out, 0);
+        return _success_bebi32(buf_out);
+    }
+    // reduce sender balance and store into the same slot
+    bebi32_sub(balance_buf, amount);
+    storage_store(storage, balance_slot_buf, balance_buf);
+
+    // load/increase/store receiver balance
+    PROFILE_BEGIN(transfer_receiver_balance);
+    balance_slot(dest, balance_slot_buf);
+    storage_load(storage, balance_slot_buf, balance_buf);
+    int overflow = bebi32_add(balance_buf, amount);
+    if (!overflow) {
+        storage_store(storage, balance_slot_buf, balance_buf);
+    }
+    PROFILE_END(transfer_receiver_balance);
+    if (overflow) {
+        return _return_nodata(Failure);
+    }
+
+    // return true
+    bebi32_set_u8(buf_out, 1);
+    return _success_bebi32(buf_out);
+}
+
 // standard ERC20:  move "value" tokens from message sender to "to"
 ArbResult transfer(void *storage, uint8_t *input, size_t len) { // transfer(address,uint256)
     // input should be two bytes32: destination (an address) and amount (uint256)
@@ -182,81 +292,181 @@ ArbResult transfer(void *storage, uint8_t *input, size_t len) { // transfer(addr
     if (!bebi32_is_u160(dest)) {
         return _return_nodata(Failure);
     }
+    return _transfer(storage, dest, amount);
+}
 
-    // read message sender
+// move values[i] tokens from message sender to to[i], for all i
+// recipients are sorted and merged first (see batch.h), so the sender's balance is
+// loaded and stored once, and each distinct recipient's balance once.
+ArbResult batchTransfer(void *storage, uint8_t *input, size_t len) { // batchTransfer(address[],uint256[])
+    uint8_t const *to;
+    uint8_t const *values;
+    size_t count;
+    size_t values_count;
+    if (_abi_array(input, len, 0, &to, &count) != 0 || _abi_array(input, len, 1, &values, &values_count) != 0) {
+        return _return_nodata(Failure);
+    }
+    if (count != values_count) {
+        return _return_short_string(Failure, "length mismatch");
+    }
+    // updates are kept on the stack
+    if (count > BATCH_MAX) {
+        return _return_short_string(Failure, "too many recipients");
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (!bebi32_is_u160(to + 32 * i)) {
+            return _return_nodata(Failure);
+        }
+    }
+    bebi32_set_u8(buf_out, 1);
+    if (count == 0) {
+        return _success_bebi32(buf_out);
+    }
+
+    // sort, merge duplicate recipients and sum the total
+    batch_update updates[count];
+    batch_load(updates, to, values, count);
+    size_t recipients;
+    bebi32 total;
+    if (batch_merge(updates, count, &recipients, total) != 0) {
+        return _return_nodata(Failure);
+    }
+
+    // debit the total from the sender once
     bebi32 sender;
     msg_sender_padded(sender);
-    // calculate the storage slot for sender's balance
     bebi32 balance_slot_buf;
     balance_slot(sender, balance_slot_buf);
-    // read the sender's balance
     bebi32 balance_buf;
     storage_load(storage, balance_slot_buf, balance_buf);
-    // check if sender has enough balance
+    if (bebi32_cmp(balance_buf, total) < 0) {
+        // return false, as transfer does
+        bebi32_set_u8(buf_out, 0);
+        return _success_bebi32(buf_out);
+    }
+    bebi32_sub(balance_buf, total);
+    storage_store(storage, balance_slot_buf, balance_buf);
+
+    // credit each distinct recipient. The sender may be one of them: its balance is reloaded.
+    bebi32 balances_base = STORAGE_SLOT__balances;
+    if (batch_add_to_map(balances_base, updates, recipients) != 0) {
+        return _return_nodata(Failure);
+    }
+    return _success_bebi32(buf_out);
+}
+
+// standard ERC20: a read accessor to the allowances map
+ArbResult allowance(const void *storage, uint8_t *input, size_t len) { // allowance(address,address)
+    // validate input is two addresses padded to 32 bytes
+    if (len != 64) {
+        return _return_nodata(Failure);
+    }
+    uint8_t const *owner = input;
+    uint8_t const *spender = (input + 32);
+    if (!bebi32_is_u160(owner) || !bebi32_is_u160(spender)) {
+        return _return_nodata(Failure);
+    }
+    bebi32 slot;
+    allowance_slot(owner, spender, slot);
+    storage_load(storage, slot, buf_out);
+    return _success_bebi32(buf_out);
+}
+
+// standard ERC20: allow spender to transfer up to "value" of message sender's tokens
+ArbResult approve(void *storage, uint8_t *input, size_t len) { // approve(address,uint256)
+    if (len != 64) {
+        return _return_nodata(Failure);
+    }
+    uint8_t const *spender = input;
+    uint8_t const *amount = (input + 32);
+    if (!bebi32_is_u160(spender)) {
+        return _return_nodata(Failure);
+    }
+    bebi32 sender;
+    msg_sender_padded(sender);
+    bebi32 slot;
+    allowance_slot(sender, spender, slot);
+    storage_store(storage, slot, amount);
+
+    // return true
+    bebi32_set_u8(buf_out, 1);
+    return _success_bebi32(buf_out);
+}
+
+// standard ERC20: move "value" tokens from "from" to "to", using message sender's allowance
+ArbResult transferFrom(void *storage, uint8_t *input, size_t len) { // transferFrom(address,address,uint256)
+    // input should be three bytes32: source, destination (addresses) and amount (uint256)
+    if (len != 96) {
+        return _return_nodata(Failure);
+    }
+    uint8_t const *from = input;
+    uint8_t const *dest = (input + 32);
+    uint8_t const *amount = (input + 64);
+    if (!bebi32_is_u160(from) || !bebi32_is_u160(dest)) {
+        return _return_nodata(Failure);
+    }
+
+    // read the allowance given by "from" to message sender
+    bebi32 sender;
+    msg_sender_padded(sender);
+    bebi32 allowance_slot_buf;
+    allowance_slot(from, sender, allowance_slot_buf);
+    bebi32 allowance_buf;
+    storage_load(storage, allowance_slot_buf, allowance_buf);
+    if (bebi32_cmp(allowance_buf, amount) < 0) {
+        return _return_short_string(Failure, "insufficient allowance");
+    }
+
+    // read the source balance, and check it's enough
+    bebi32 balance_slot_buf;
+    balance_slot(from, balance_slot_buf);
+    bebi32 balance_buf;
+    storage_load(storage, balance_slot_buf, balance_buf);
     if (bebi32_cmp(balance_buf, amount) < 0) {
         // return false
-        // notice we return a Success here because we do not revert
         bebi32_set_u8(buf_out, 0);
         return _success_bebi32(buf_out);
     }
-    // reduce sender balance and store into the same slot
+
+    // an allowance of max uint256 is never reduced
+    bebi32 max_allowance;
+    memset(max_allowance, 0xff, 32);
+    if (bebi32_cmp(allowance_buf, max_allowance) != 0) {
+        bebi32_sub(allowance_buf, amount);
+        storage_store(storage, allowance_slot_buf, allowance_buf);
+    }
+
+    // reduce source balance and store into the same slot
     bebi32_sub(balance_buf, amount);
     storage_store(storage, balance_slot_buf, balance_buf);
 
     // load/increase/store receiver balance
+    PROFILE_BEGIN(transferFrom_receiver_balance);
     balance_slot(dest, balance_slot_buf);
     storage_load(storage, balance_slot_buf, balance_buf);
     int overflow = bebi32_add(balance_buf, amount);
+    if (!overflow) {
+        storage_store(storage, balance_slot_buf, balance_buf);
+    }
+    PROFILE_END(transferFrom_receiver_balance);
     if (overflow) {
         return _return_nodata(Failure);
     }
-    storage_store(storage, balance_slot_buf, balance_buf);
 
     // return true
     bebi32_set_u8(buf_out, 1);
     return _success_bebi32(buf_out);
 }
 
-// push_minter adds to the end of minters_array, and updates minter_idx map
-void push_minter(void *storage, bebi32 minter) {
-    // read array size
-    bebi32 array_size_slot = STORAGE_SLOT_minters;
-    bebi32 array_size;
-    storage_load(storage, array_size_slot, array_size);
-    // in solidity array size is uint256 - but a going over 1<<64
-    // is not feasible, so for C we use a u64 index.
-    if (!bebi32_is_u64(array_size)) {
-        revert();
-    }
-    uint64_t index = bebi32_get_u64(array_size);
-
-    // address 0 is never marked "minter"
-    if (!bebi32_is_zero(minter)) {
-        // compute memory slot for the index
-        bebi32 idx_slot;
-        minter_idx_storage_slot(minter, idx_slot);
-        // store the u64 index into a 32-byte value
-        bebi32 idx_bebi;
-        bebi32_set_u64(idx_bebi, index);
-        // store value
-        storage_store(storage, idx_slot, idx_bebi);
-    }
-
-    // calculate storage slot in the end of the array
-    bebi32 minters_slot;
-    bebi32 minters_base = STORAGE_BASE_minters;
-    array_slot_offset(minters_base, 32, index, minters_slot, NULL);
-    // store minter into it's slot
-    storage_store(storage, minters_slot, minter);
-    // store the increased array size into it's slot
-    bebi32_set_u64(array_size, index+1);
-    storage_store(storage, array_size_slot, array_size);
-}
+// minters array and minter_idx map form an enumerable set.
+// Index 0 of the array is a reserved blank, so minter_idx 0 means "not a minter".
+static const enumerable_set minters_set = ENUMERABLE_SET_INIT(STORAGE_SLOT_minters, STORAGE_BASE_minters,
+                                                              STORAGE_SLOT_minter_idx, 1);
 
 // set the first minter
 ArbResult init(void *storage, uint8_t *input, size_t len) { // init()
-    // validate_input
-    if (len != 32 || !bebi32_is_u160(input)) {
+    // validate_input, address 0 is never a minter
+    if (len != 32 || !bebi32_is_u160(input) || bebi32_is_zero(input)) {
         return _return_nodata(Failure);
     }
     bool initialized;
@@ -265,11 +475,13 @@ ArbResult init(void *storage, uint8_t *input, size_t len) { // init()
         // revert with reason string
         return _return_short_string(Failure, "already initialized");
     }
-    // first blank entry reserves index 0 for non-minters
-    bebi32 zero_minter = {0};
-    push_minter(storage, zero_minter);
-    // push the first minter
-    push_minter(storage, input);
+    // first blank entry reserves index 0 for non-minters (the entry itself is already 0)
+    bebi32 array_size_slot = STORAGE_SLOT_minters;
+    bebi32 array_size;
+    bebi32_set_u64(array_size, 1);
+    storage_store(storage, array_size_slot, array_size);
+    // add the first minter
+    enumerable_set_add(&minters_set, input);
     // store_shorts sets minters_current and initialized
     store_shorts(storage, 1);
     return _return_nodata(Success);
@@ -279,7 +491,7 @@ ArbResult init(void *storage, uint8_t *input, size_t len) { // init()
 bool from_minter(const void *storage) {
     bebi32 sender;
     msg_sender_padded(sender);
-    return  _minter_idx(storage, sender) != 0;
+    return enumerable_set_contains(&minters_set, sender);
 }
 
 // add a new minter
@@ -288,20 +500,21 @@ ArbResult add_minter(void *storage, uint8_t *input, size_t len) { // add_minter(
         //revert with reason string
         return _return_short_string(Failure, "must be a minter");
     }
-    if (len != 32 || !bebi32_is_u160(input)) {
+    if (len != 32 || !bebi32_is_u160(input) || bebi32_is_zero(input)) {
         return _return_nodata(Failure);
     }
+    // adding an existing minter changes nothing
+    if (enumerable_set_add(&minters_set, input) == 0) {
+        return _return_nodata(Success);
+    }
     uint64_t minters_current;
     load_shorts(storage, &minters_current, NULL);
-
-    push_minter(storage, input);
-    minters_current +=1;
-    store_shorts(storage, minters_current);
+    store_shorts(storage, minters_current + 1);
     return _return_nodata(Success);
 }
 
 // remove minter
-// array entry is replaced with blank
+// the last minter in the array takes its index, and the array is popped
 // minter_idx map entry is removed
 ArbResult remove_minter(void *storage, uint8_t *input, size_t len) { // remove_minter(address)
     if (!from_minter(storage)) {
@@ -311,28 +524,10 @@ ArbResult remove_minter(void *storage, uint8_t *input, size_t len) { // remove_m
     if (len != 32 || !bebi32_is_u160(input)) {
         return _return_nodata(Failure);
     }
-    // compute slot and load minter index
-    bebi32 idx_slot;
-    bebi32 buf;
-    minter_idx_storage_slot(input, idx_slot);
-    storage_load(storage, idx_slot, buf);
-    uint64_t idx = bebi32_get_u32(buf);
-    if (!idx) {
+    if (enumerable_set_remove(&minters_set, input) == 0) {
         //revert with reason string
         return  _return_short_string(Failure, "remove: not minter");
     }
-    bebi32 zero;
-    memset(zero, 0, 32);
-
-    // remove index from map
-    storage_store(storage, idx_slot, zero);
-
-    // compute slot of minter in the minters array
-    bebi32 minters_slot;
-    bebi32 minters_base = STORAGE_SLOT_minters;
-    array_slot_offset(minters_base, 32, idx, minters_slot, NULL);
-    // store 0 in the minters array
-    storage_store(storage, minters_slot, zero);
 
     // reduce minters_current count
     uint64_t minters_current;
@@ -408,7 +603,7 @@ ArbResult minters(const void *storage, uint8_t *input, size_t len) { // minters(
     }
     // load entry and return it
     bebi32 minters_slot;
-    bebi32 minters_base = STORAGE_SLOT_minters;
+    bebi32 minters_base = STORAGE_BASE_minters;
     array_slot_offset(minters_base, 32, index, minters_slot, NULL);
     storage_load(storage, minters_slot, buf_out);
     return _success_bebi32(buf_out);
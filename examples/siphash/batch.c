@@ -0,0 +1,74 @@
+// Copyright 2022-2023, Offchain Labs, Inc.
+// For licensing, see https://github.com/OffchainLabs/stylus-sdk-c/blob/stylus/licenses/COPYRIGHT.md
+//
+// Batch entrypoint: hashes many messages under one key in a single call, so the per-call
+// overhead is paid once. Messages are hashed in pairs (see siphash24_x2), which uses simd128
+// when built with -msimd128.
+//
+// input: the 16-byte key, then for each message its 2-byte big-endian length and its bytes
+// output: the 8-byte hash of each message, in order, encoded as in main.c
+
+#include "stylus_entry.h"
+
+#define MAX_MESSAGES 256
+
+// siphash impl from siphash.c
+extern uint64_t siphash24(const void *src, unsigned long len, const uint8_t key[16]);
+extern void siphash24_x2(const void *src0, unsigned long len0, const void *src1, unsigned long len1,
+                         const uint8_t key[16], uint64_t out[2]);
+
+static uint64_t hashes[MAX_MESSAGES];
+
+static ArbResult failure() {
+    return (ArbResult) { .status = Failure, .output = NULL, .output_len = 0 };
+}
+
+// reads the message at *pos, and moves *pos past it. returns false if out of bounds
+static bool next_message(const uint8_t *args, size_t args_len, size_t *pos,
+                         const uint8_t **msg, size_t *len) {
+    if (args_len - *pos < 2) {
+        return false;
+    }
+    *len = ((size_t)args[*pos] << 8) | args[*pos + 1];
+    *pos += 2;
+    if (args_len - *pos < *len) {
+        return false;
+    }
+    *msg = args + *pos;
+    *pos += *len;
+    return true;
+}
+
+ArbResult batch_main(uint8_t * args, size_t args_len) {
+    if (args_len < 16) {
+        return failure();
+    }
+    const uint8_t * key = args;
+    size_t pos = 16;
+    size_t count = 0;
+
+    while (pos < args_len) {
+        const uint8_t *msg0, *msg1;
+        size_t len0, len1;
+        if (count == MAX_MESSAGES || !next_message(args, args_len, &pos, &msg0, &len0)) {
+            return failure();
+        }
+        if (pos == args_len) {
+            hashes[count++] = siphash24(msg0, len0, key);
+            break;
+        }
+        if (count + 1 == MAX_MESSAGES || !next_message(args, args_len, &pos, &msg1, &len1)) {
+            return failure();
+        }
+        siphash24_x2(msg0, len0, msg1, len1, key, &hashes[count]);
+        count += 2;
+    }
+
+    return (ArbResult) {
+        .status = Success,
+        .output = (uint8_t *)hashes,
+        .output_len = count * sizeof(uint64_t),
+    };
+}
+
+ENTRYPOINT(batch_main);
@@ -25,38 +25,40 @@
 	HALF_ROUND(v2,v1,v0,v3,17,21);
 
 
-uint64_t siphash24(const void *src, unsigned long len, const uint8_t key[16]) {
-	const uint64_t *_key = (uint64_t *)key;
-	uint64_t k0 = _le64toh(_key[0]);
-	uint64_t k1 = _le64toh(_key[1]);
+// unaligned little-endian loads, without aliasing casts
+static inline uint64_t load64(const uint8_t *p) {
+	uint64_t v;
+	__builtin_memcpy(&v, p, sizeof(v));
+	return _le64toh(v);
+}
+
+// the last 0-7 bytes of the message, with the length in the top byte
+static inline uint64_t last_word(const uint8_t *m, unsigned long len) {
 	uint64_t b = (uint64_t)len << 56;
-	const uint64_t *in = (uint64_t*)src;
+	uint64_t t = 0;
+	__builtin_memcpy(&t, m + (len & ~7UL), len & 7);
+	return b | _le64toh(t);
+}
+
+uint64_t siphash24(const void *src, unsigned long len, const uint8_t key[16]) {
+	uint64_t k0 = load64(key);
+	uint64_t k1 = load64(key + 8);
+	const uint8_t *in = (const uint8_t *)src;
+	uint64_t b = last_word(in, len);
 
 	uint64_t v0 = k0 ^ 0x736f6d6570736575ULL;
 	uint64_t v1 = k1 ^ 0x646f72616e646f6dULL;
 	uint64_t v2 = k0 ^ 0x6c7967656e657261ULL;
 	uint64_t v3 = k1 ^ 0x7465646279746573ULL;
 
-	while (len >= 8) {
-		uint64_t mi = _le64toh(*in);
-		in += 1; len -= 8;
+	for (unsigned long blocks = len / 8; blocks > 0; blocks--) {
+		uint64_t mi = load64(in);
+		in += 8;
 		v3 ^= mi;
 		DOUBLE_ROUND(v0,v1,v2,v3);
 		v0 ^= mi;
 	}
 
-	uint64_t t = 0; uint8_t *pt = (uint8_t *)&t; uint8_t *m = (uint8_t *)in;
-	switch (len) {
-	case 7: pt[6] = m[6];
-	case 6: pt[5] = m[5];
-	case 5: pt[4] = m[4];
-	case 4: *((uint32_t*)&pt[0]) = *((uint32_t*)&m[0]); break;
-	case 3: pt[2] = m[2];
-	case 2: pt[1] = m[1];
-	case 1: pt[0] = m[0];
-	}
-	b |= _le64toh(t);
-
 	v3 ^= b;
 	DOUBLE_ROUND(v0,v1,v2,v3);
 	v0 ^= b; v2 ^= 0xff;
@@ -64,3 +66,79 @@ uint64_t siphash24(const void *src, unsigned long len, const uint8_t key[16]) {
 	DOUBLE_ROUND(v0,v1,v2,v3);
 	return (v0 ^ v1) ^ (v2 ^ v3);
 }
+
+#ifdef __wasm_simd128__
+
+// two messages at once: lane 0 and lane 1 of each i64x2 vector
+typedef uint64_t u64x2 __attribute__((vector_size(16)));
+
+#define ROTATE_X2(x, b) (((x) << (b)) | ((x) >> (64 - (b))))
+
+#define HALF_ROUND_X2(a,b,c,d,s,t)		\
+	a += b; c += d;				\
+	b = ROTATE_X2(b, s) ^ a;		\
+	d = ROTATE_X2(d, t) ^ c;		\
+	a = ROTATE_X2(a, 32);
+
+#define DOUBLE_ROUND_X2(v0,v1,v2,v3)		\
+	HALF_ROUND_X2(v0,v1,v2,v3,13,16);	\
+	HALF_ROUND_X2(v2,v1,v0,v3,17,21);	\
+	HALF_ROUND_X2(v0,v1,v2,v3,13,16);	\
+	HALF_ROUND_X2(v2,v1,v0,v3,17,21);
+
+void siphash24_x2(const void *src0, unsigned long len0, const void *src1, unsigned long len1,
+		  const uint8_t key[16], uint64_t out[2]) {
+	uint64_t k0 = load64(key);
+	uint64_t k1 = load64(key + 8);
+	const uint8_t *in0 = (const uint8_t *)src0;
+	const uint8_t *in1 = (const uint8_t *)src1;
+
+	u64x2 v0 = (u64x2){k0, k0} ^ 0x736f6d6570736575ULL;
+	u64x2 v1 = (u64x2){k1, k1} ^ 0x646f72616e646f6dULL;
+	u64x2 v2 = (u64x2){k0, k0} ^ 0x6c7967656e657261ULL;
+	u64x2 v3 = (u64x2){k1, k1} ^ 0x7465646279746573ULL;
+
+	// compress the blocks both messages have in both lanes
+	unsigned long blocks0 = len0 / 8, blocks1 = len1 / 8;
+	unsigned long shared = blocks0 < blocks1 ? blocks0 : blocks1;
+	for (unsigned long i = 0; i < shared; i++) {
+		u64x2 mi = {load64(in0 + 8 * i), load64(in1 + 8 * i)};
+		v3 ^= mi;
+		DOUBLE_ROUND_X2(v0,v1,v2,v3);
+		v0 ^= mi;
+	}
+
+	// the longer message finishes its blocks with the other lane idle
+	if (blocks0 != blocks1) {
+		int lane = blocks0 > blocks1 ? 0 : 1;
+		const uint8_t *in = lane == 0 ? in0 : in1;
+		uint64_t s0 = v0[lane], s1 = v1[lane], s2 = v2[lane], s3 = v3[lane];
+		for (unsigned long i = shared; i < (lane == 0 ? blocks0 : blocks1); i++) {
+			uint64_t mi = load64(in + 8 * i);
+			s3 ^= mi;
+			DOUBLE_ROUND(s0,s1,s2,s3);
+			s0 ^= mi;
+		}
+		v0[lane] = s0; v1[lane] = s1; v2[lane] = s2; v3[lane] = s3;
+	}
+
+	u64x2 b = {last_word(in0, len0), last_word(in1, len1)};
+	v3 ^= b;
+	DOUBLE_ROUND_X2(v0,v1,v2,v3);
+	v0 ^= b; v2 ^= 0xff;
+	DOUBLE_ROUND_X2(v0,v1,v2,v3);
+	DOUBLE_ROUND_X2(v0,v1,v2,v3);
+	u64x2 hash = (v0 ^ v1) ^ (v2 ^ v3);
+	out[0] = hash[0];
+	out[1] = hash[1];
+}
+
+#else
+
+void siphash24_x2(const void *src0, unsigned long len0, const void *src1, unsigned long len1,
+		  const uint8_t key[16], uint64_t out[2]) {
+	out[0] = siphash24(src0, len0, key);
+	out[1] = siphash24(src1, len1, key);
+}
+
+#endif // __wasm_simd128__
@@ -0,0 +1,74 @@
+#ifndef __BATCH_H
+#define __BATCH_H
+
+/**
+ * batch.h applies many amount updates to a mapping (e.g. token balances) in one call
+ *
+ * Updates are sorted by key, and updates to the same key are merged by summing their amounts,
+ * so each distinct key costs one map_slot keccak, one SLOAD and one SSTORE however many times
+ * it appears. The total of all amounts is computed in the same pass, so a batch transfer can
+ * debit the source once.
+ *
+ * Sorting is an in-place heapsort: O(n log n) in the worst case, no allocation.
+ *
+ * Callers usually keep the updates on the stack, one batch_update (36 bytes on wasm32) per
+ * element: bound the element count with BATCH_MAX before declaring the array.
+ *
+ * requires: bebi.h(string.h), storage.h, hostio.h
+ * c-file: batch.c
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <bebi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// most updates a caller should keep on the stack: 64 take 2.3KB of the 8KB stack
+#ifndef BATCH_MAX
+#define BATCH_MAX 64
+#endif
+
+/**
+ * key: 32 bytes (e.g. a padded address), not copied. Usually points into the call's args
+ * amount: the 32-byte big-endian amount
+ */
+typedef struct batch_update {
+    const uint8_t *key;
+    bebi32 amount;
+} batch_update;
+
+/**
+ * fills updates from n consecutive 32-byte keys and n consecutive 32-byte amounts,
+ * e.g. the elements of ABI-encoded address[] and uint256[] arrays
+ */
+void batch_load(batch_update *updates, const uint8_t *keys, const uint8_t *amounts, size_t n);
+
+/**
+ * sorts updates by key
+ */
+void batch_sort(batch_update *updates, size_t n);
+
+/**
+ * sorts updates, merges updates with the same key and drops updates with a zero amount.
+ * n_out receives the number of remaining updates, at the start of the array.
+ * total_out (may be NULL) receives the sum of all amounts.
+ * returns 0 on success, -1 if a sum overflows 256 bits
+ */
+int batch_merge(batch_update *updates, size_t n, size_t *n_out, bebi32 total_out);
+
+/**
+ * adds each amount to the value at map_slot(map_base, key)
+ * for merged updates: one keccak, one SLOAD and one SSTORE per update.
+ * returns 0 on success, -1 if a value overflows. Updates before the overflowing one were
+ * already stored, so the caller should fail the call.
+ */
+int batch_add_to_map(bebi32 const map_base, const batch_update *updates, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __BATCH_H
@@ -11,6 +11,15 @@
  * Only addition/subtraction and comparisons are supported for math (which is enough for quite a lot)
  * Currently only supporting unsigned.
  *  
+ * With STYLUS_SIZE_OPT defined, the bebi_* helpers are out-of-line functions in bebi.c, and
+ * the get/set functions use one loop for every width instead of unrolled code. This makes
+ * the wasm smaller and calls slower. All files must be built with the same setting.
+ *
+ * The size variant uses loops rather than lookup tables: a table for the get/set functions
+ * would hold the shift of each byte position (8 * i), which the loop computes with the same
+ * single shift, so it would only add data. The SDK's tables are where they replace unrolled
+ * code, e.g. keccak.c's round constants, rotations and lane order, used by both variants.
+ *
  * c-file: bebi.c
  * requires: string.h
  */
@@ -23,6 +32,12 @@
 extern "C" {
 #endif
 
+#ifdef STYLUS_SIZE_OPT
+#define BEBI_INLINE
+#else
+#define BEBI_INLINE inline
+#endif
+
 /**
  * bebi type does not have a predefined size or alignment requirements
  */
@@ -31,15 +46,15 @@ typedef uint8_t bebi[];
 /**
  * Set/get functions allow extracting or setting a u8/16/32/64 from any offset inside the bebi
  */
-inline void bebi_set_u8(bebi dst, size_t offset, uint8_t val);
-inline void bebi_set_u16(bebi dst, size_t offset, uint16_t val);
-inline void bebi_set_u32(bebi dst, size_t offset, uint32_t val);
-inline void bebi_set_u64(bebi dst, size_t offset, uint64_t val);
+BEBI_INLINE void bebi_set_u8(bebi dst, size_t offset, uint8_t val);
+BEBI_INLINE void bebi_set_u16(bebi dst, size_t offset, uint16_t val);
+BEBI_INLINE void bebi_set_u32(bebi dst, size_t offset, uint32_t val);
+BEBI_INLINE void bebi_set_u64(bebi dst, size_t offset, uint64_t val);
 
-inline uint8_t bebi_get_u8(const bebi src, size_t offset);
-inline uint16_t bebi_get_u16(const bebi src, size_t offset);
-inline uint32_t bebi_get_u32(const bebi src, size_t offset);
-inline uint64_t bebi_get_u64(const bebi src, size_t offset);
+BEBI_INLINE uint8_t bebi_get_u8(const bebi src, size_t offset);
+BEBI_INLINE uint16_t bebi_get_u16(const bebi src, size_t offset);
+BEBI_INLINE uint32_t bebi_get_u32(const bebi src, size_t offset);
+BEBI_INLINE uint64_t bebi_get_u64(const bebi src, size_t offset);
 
 /**
  * Adds rhs into lhs. Lhs must be at least as long as rhs.
@@ -49,7 +64,7 @@ inline uint64_t bebi_get_u64(const bebi src, size_t offset);
  * 0 : O.k
  * 1 : O.k but there was an overflow
  */
-inline int bebi_add(bebi lhs, size_t lhs_size, const bebi rhs, size_t rhs_size);
+BEBI_INLINE int bebi_add(bebi lhs, size_t lhs_size, const bebi rhs, size_t rhs_size);
 
 /**
  * Subtracts rhs from lhs. Lhs must be at least as long as rhs.
@@ -59,7 +74,7 @@ inline int bebi_add(bebi lhs, size_t lhs_size, const bebi rhs, size_t rhs_size);
  * 0 : O.k
  * 1 : O.k but there was an overflow
  */
-inline int bebi_sub(bebi lhs, size_t lhs_size, const bebi rhs, size_t rhs_size);
+BEBI_INLINE int bebi_sub(bebi lhs, size_t lhs_size, const bebi rhs, size_t rhs_size);
 
 /**
  * compares two values
@@ -69,9 +84,9 @@ inline int bebi_sub(bebi lhs, size_t lhs_size, const bebi rhs, size_t rhs_size);
  * lhs < rhs: -1
  * lhs == rhs: 0
  */
-inline int bebi_cmp(const bebi lhs, size_t lhs_size, const bebi rhs, size_t rhs_size);
+BEBI_INLINE int bebi_cmp(const bebi lhs, size_t lhs_size, const bebi rhs, size_t rhs_size);
 
-inline bool bebi_is_zero(const bebi bebi, size_t size);
+BEBI_INLINE bool bebi_is_zero(const bebi bebi, size_t size);
 
 /**
  * bebi32 is a specialized bebi of size 32, which is used a lot in solidity
@@ -115,7 +130,11 @@ bool bebi32_is_zero(const bebi bebi);
 
 
 /******* implementation of previously-declated functions *********/
-inline int bebi_add(bebi lhs, size_t lhs_size, const bebi rhs, size_t rhs_size) {
+
+// with STYLUS_SIZE_OPT, these are defined only in bebi.c (which defines BEBI_IMPL)
+#if !defined(STYLUS_SIZE_OPT) || defined(BEBI_IMPL)
+
+BEBI_INLINE int bebi_add(bebi lhs, size_t lhs_size, const bebi rhs, size_t rhs_size) {
     if (rhs_size > lhs_size) {
         return -1;
     }
@@ -138,7 +157,7 @@ inline int bebi_add(bebi lhs, size_t lhs_size, const bebi rhs, size_t rhs_size)
     return carry;
 }
 
-inline int bebi_sub(bebi lhs, size_t lhs_size, const bebi rhs, size_t rhs_size) {
+BEBI_INLINE int bebi_sub(bebi lhs, size_t lhs_size, const bebi rhs, size_t rhs_size) {
     if (rhs_size > lhs_size) {
         return -1;
     }
@@ -161,7 +180,7 @@ inline int bebi_sub(bebi lhs, size_t lhs_size, const bebi rhs, size_t rhs_size)
     return carry;
 }
 
-inline int bebi_cmp(const bebi lhs, size_t lhs_size, const bebi rhs, size_t rhs_size) {
+BEBI_INLINE int bebi_cmp(const bebi lhs, size_t lhs_size, const bebi rhs, size_t rhs_size) {
     size_t left = 0;
     size_t right = 0;
     while (lhs_size - left > rhs_size) {
@@ -189,11 +208,11 @@ inline int bebi_cmp(const bebi lhs, size_t lhs_size, const bebi rhs, size_t rhs_
     return 0;
 }
 
-inline void bebi_set_u8(bebi dst, size_t offset, uint8_t val) {
+BEBI_INLINE void bebi_set_u8(bebi dst, size_t offset, uint8_t val) {
     dst[offset] = val;
 }
 
-inline bool bebi_is_zero(const bebi bebi, size_t size) {
+BEBI_INLINE bool bebi_is_zero(const bebi bebi, size_t size) {
     size_t idx = 0;
     while (idx < size) {
         if (bebi[idx] != 0) {
@@ -204,17 +223,22 @@ inline bool bebi_is_zero(const bebi bebi, size_t size) {
     return true;
 }
 
-inline uint8_t bebi_get_u8(const bebi src, size_t offset) {
+BEBI_INLINE uint8_t bebi_get_u8(const bebi src, size_t offset) {
     return src[offset];
 }
 
-inline void bebi_set_u16(bebi dst, size_t offset, uint16_t val) {
+#endif
+
+// with STYLUS_SIZE_OPT, bebi.c has loop-based versions instead
+#ifndef STYLUS_SIZE_OPT
+
+BEBI_INLINE void bebi_set_u16(bebi dst, size_t offset, uint16_t val) {
     dst[offset+1] = val & 0xff;
     val >>= 8;
     dst[offset] = val & 0xff;
 }
 
-inline uint16_t bebi_get_u16(const bebi src, size_t offset) {
+BEBI_INLINE uint16_t bebi_get_u16(const bebi src, size_t offset) {
     uint16_t val;
     val = src[offset];
     val <<= 8;
@@ -222,7 +246,7 @@ inline uint16_t bebi_get_u16(const bebi src, size_t offset) {
     return val;
 }
 
-inline void bebi_set_u32(bebi dst, size_t offset, uint32_t val) {
+BEBI_INLINE void bebi_set_u32(bebi dst, size_t offset, uint32_t val) {
     dst[offset+3] = val & 0xff;
     val >>= 8;
     dst[offset+2] = val & 0xff;
@@ -232,7 +256,7 @@ inline void bebi_set_u32(bebi dst, size_t offset, uint32_t val) {
     dst[offset] = val & 0xff;
 }
 
-inline uint32_t bebi_get_u32(const bebi src, size_t offset) {
+BEBI_INLINE uint32_t bebi_get_u32(const bebi src, size_t offset) {
     uint32_t val;
     val = src[offset];
     val <<= 8;
@@ -244,7 +268,7 @@ inline uint32_t bebi_get_u32(const bebi src, size_t offset) {
     return val;
 }
 
-inline void bebi_set_u64(bebi dst, size_t offset, uint64_t val) {
+BEBI_INLINE void bebi_set_u64(bebi dst, size_t offset, uint64_t val) {
     dst[offset+7] = val & 0xff;
     val >>= 8;
     dst[offset+6] = val & 0xff;
@@ -262,7 +286,7 @@ inline void bebi_set_u64(bebi dst, size_t offset, uint64_t val) {
     dst[offset] = val & 0xff;
 }
 
-inline uint64_t bebi_get_u64(const bebi src, size_t offset) {
+BEBI_INLINE uint64_t bebi_get_u64(const bebi src, size_t offset) {
     uint64_t val;
     val = src[offset];
     val <<= 8;
@@ -282,6 +306,8 @@ inline uint64_t bebi_get_u64(const bebi src, size_t offset) {
     return val;
 }
 
+#endif // STYLUS_SIZE_OPT
+
 #ifdef __cplusplus
 }
 #endif
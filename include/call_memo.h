@@ -0,0 +1,96 @@
+#ifndef __CALL_MEMO_H
+#define __CALL_MEMO_H
+
+/**
+ * call_memo.h serves repeated static calls from memory
+ *
+ * A contract that reads the same oracle or registry several times in one call pays for a
+ * static_call_contract and a read_return_data every time. A call_memo remembers the
+ * return data of successful static calls, keyed by the target and keccak256(calldata), so
+ * a repeated call with the same target and calldata makes no hostio beyond that keccak.
+ * The calldata is hashed where it is, without being copied.
+ *
+ * The memo is opt-in and owned by the caller, along with its storage:
+ *
+ * call_memo_entry entries[4];
+ * uint8_t buf[256];
+ * call_memo memo;
+ * call_memo_init(&memo, entries, 4, buf, sizeof(buf));
+ *
+ * Only the requested window of the return data is kept. A later call asking for bytes
+ * outside the kept window is made again, and remembered as a new entry.
+ *
+ * Results are only valid while the state they read is unchanged. Within a call that is
+ * true until the contract makes a call that may write (call_contract, delegate_call_contract,
+ * deploys) or writes storage the target reads back through reentrancy: call_memo_clear
+ * after those. Declare the memo in the entrypoint (not as a global) so it never outlives
+ * the call.
+ *
+ * Failed calls are not remembered. When the memo is full calls are still made,
+ * they are just not remembered.
+ *
+ * requires: keccak.h, hostio.h, bebi.h(string.h)
+ * c-file: call_memo.c
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <bebi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * fields are private
+ */
+typedef struct call_memo_entry {
+    uint8_t target[20];
+    bebi32 key;
+    size_t return_data_len;
+    size_t offset;
+    size_t len;
+    const uint8_t *data;
+} call_memo_entry;
+
+typedef struct call_memo {
+    call_memo_entry *entries;
+    size_t entries_cap;
+    size_t count;
+    uint8_t *buf;
+    size_t buf_cap;
+    size_t buf_used;
+} call_memo;
+
+/**
+ * entries: room for entries_cap remembered calls
+ * buf: holds the return data windows of all entries
+ */
+void call_memo_init(call_memo *memo, call_memo_entry *entries, size_t entries_cap, uint8_t *buf, size_t buf_cap);
+
+/**
+ * forget all remembered calls
+ */
+void call_memo_clear(call_memo *memo);
+
+/**
+ * static_call_contract, then read_return_data(dest, offset, size), unless the same target
+ * and calldata were called before through this memo.
+ *
+ * Returns the status of the call (0 on success). On success *return_data_len_out is set
+ * to the full length of the return data, and the window [offset, offset + size), cut at
+ * the end of the return data, is copied to dest. offset past the end of the return data
+ * reverts, like read_return_data.
+ *
+ * On failure nothing is copied, and the revert data can be read with read_return_data.
+ * After a call served from the memo, read_return_data still reads the last call made.
+ */
+uint8_t call_memo_static_call(call_memo *memo, const uint8_t *target, const uint8_t *calldata,
+                              size_t calldata_len, uint64_t gas, uint8_t *dest, size_t offset, size_t size,
+                              size_t *return_data_len_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __CALL_MEMO_H
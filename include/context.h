@@ -0,0 +1,119 @@
+#ifndef __CONTEXT_H
+#define __CONTEXT_H
+
+/**
+ * context.h caches the msg/tx/block context of the current call
+ *
+ * Each accessor calls its hostio the first time it is used, and returns the cached value
+ * afterwards, so a call pays for each context hostio at most once however many helpers
+ * ask for it. msg_sender_padded (stylus_utils.h) reads the sender through this cache.
+ *
+ * Addresses and msg_value are returned as pointers into the cache (20 and 32 bytes),
+ * valid until the end of the call. Fields of stylus_context are private.
+ *
+ * On-chain every call runs in a fresh wasm instance, so the cache starts out empty.
+ * Hosts that reuse an instance between calls (such as the native simulator) must call
+ * context_reset before each call.
+ *
+ * requires: hostio.h, bebi.h(string.h)
+ * c-file: utils.c
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <bebi.h>
+#include <hostio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CONTEXT_MSG_SENDER (1 << 0)
+#define CONTEXT_MSG_VALUE (1 << 1)
+#define CONTEXT_CONTRACT_ADDRESS (1 << 2)
+#define CONTEXT_TX_ORIGIN (1 << 3)
+#define CONTEXT_BLOCK_TIMESTAMP (1 << 4)
+#define CONTEXT_BLOCK_NUMBER (1 << 5)
+#define CONTEXT_CHAINID (1 << 6)
+
+typedef struct stylus_context_cache {
+    uint32_t fetched;
+    uint8_t msg_sender[20];
+    bebi32 msg_value;
+    uint8_t contract_address[20];
+    uint8_t tx_origin[20];
+    uint64_t block_timestamp;
+    uint64_t block_number;
+    uint64_t chainid;
+} stylus_context_cache;
+
+extern stylus_context_cache stylus_context;
+
+/**
+ * forget all cached values
+ */
+inline void context_reset() {
+    stylus_context.fetched = 0;
+}
+
+inline const uint8_t *context_msg_sender() {
+    if (!(stylus_context.fetched & CONTEXT_MSG_SENDER)) {
+        msg_sender(stylus_context.msg_sender);
+        stylus_context.fetched |= CONTEXT_MSG_SENDER;
+    }
+    return stylus_context.msg_sender;
+}
+
+inline const uint8_t *context_msg_value() {
+    if (!(stylus_context.fetched & CONTEXT_MSG_VALUE)) {
+        msg_value(stylus_context.msg_value);
+        stylus_context.fetched |= CONTEXT_MSG_VALUE;
+    }
+    return stylus_context.msg_value;
+}
+
+inline const uint8_t *context_contract_address() {
+    if (!(stylus_context.fetched & CONTEXT_CONTRACT_ADDRESS)) {
+        contract_address(stylus_context.contract_address);
+        stylus_context.fetched |= CONTEXT_CONTRACT_ADDRESS;
+    }
+    return stylus_context.contract_address;
+}
+
+inline const uint8_t *context_tx_origin() {
+    if (!(stylus_context.fetched & CONTEXT_TX_ORIGIN)) {
+        tx_origin(stylus_context.tx_origin);
+        stylus_context.fetched |= CONTEXT_TX_ORIGIN;
+    }
+    return stylus_context.tx_origin;
+}
+
+inline uint64_t context_block_timestamp() {
+    if (!(stylus_context.fetched & CONTEXT_BLOCK_TIMESTAMP)) {
+        stylus_context.block_timestamp = block_timestamp();
+        stylus_context.fetched |= CONTEXT_BLOCK_TIMESTAMP;
+    }
+    return stylus_context.block_timestamp;
+}
+
+inline uint64_t context_block_number() {
+    if (!(stylus_context.fetched & CONTEXT_BLOCK_NUMBER)) {
+        stylus_context.block_number = block_number();
+        stylus_context.fetched |= CONTEXT_BLOCK_NUMBER;
+    }
+    return stylus_context.block_number;
+}
+
+inline uint64_t context_chainid() {
+    if (!(stylus_context.fetched & CONTEXT_CHAINID)) {
+        stylus_context.chainid = chainid();
+        stylus_context.fetched |= CONTEXT_CHAINID;
+    }
+    return stylus_context.chainid;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __CONTEXT_H
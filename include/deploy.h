@@ -0,0 +1,88 @@
+#ifndef __DEPLOY_H
+#define __DEPLOY_H
+
+/**
+ * deploy.h computes addresses of contracts created by create1/create2,
+ * and helps factories deploy children at predictable addresses.
+ *
+ * All addresses here are 20 bytes long (not padded).
+ *
+ * requires: bebi.h(string.h), hostio.h
+ * c-file: deploy.c
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <bebi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * address of a contract created by "deployer" via CREATE with the given nonce:
+ * keccak256(rlp([deployer, nonce]))[12:]
+ */
+void create1_address(const uint8_t *deployer, uint64_t nonce, uint8_t *address_out);
+
+/**
+ * address of a contract created by "deployer" via CREATE2:
+ * keccak256(0xff ++ deployer ++ salt ++ init_code_hash)[12:]
+ */
+void create2_address(const uint8_t *deployer, bebi32 const salt, bebi32 const init_code_hash, uint8_t *address_out);
+
+/**
+ * A factory deploys a single init code many times with different salts.
+ *
+ * The hash of the init code is computed at most once. When it is known at compile time
+ * it can be given to CREATE2_FACTORY_INIT so it is never computed on-chain.
+ * The deployer address (this contract) is fetched at most once.
+ * Fields are private, use the functions below.
+ */
+typedef struct create2_factory {
+    const uint8_t *code;
+    size_t code_len;
+    bebi32 code_hash;
+    bool code_hash_set;
+    uint8_t deployer[20];
+    bool deployer_set;
+} create2_factory;
+
+/**
+ * static initializer for a factory with a precomputed init code hash, e.g:
+ * create2_factory factory = CREATE2_FACTORY_INIT(code, sizeof(code), {0x12, ... 0x34});
+ */
+#define CREATE2_FACTORY_INIT(code, code_len, ...) \
+    { (code), (code_len), __VA_ARGS__, true, {0}, false }
+
+/**
+ * initialize a factory. code_hash may be NULL, in which case it is computed on first use
+ */
+void create2_factory_init(create2_factory *factory, const uint8_t *code, size_t code_len, const uint8_t *code_hash);
+
+/**
+ * predict the address a salt would deploy to. costs a single keccak once the
+ * factory is warm
+ */
+void create2_factory_predict(create2_factory *factory, bebi32 const salt, uint8_t *address_out);
+
+/**
+ * deploy the factory's code with the given salt, unless it's already deployed.
+ *
+ * Before calling create2, the predicted address is checked for code. A create2 to an address
+ * that already has code fails and consumes all gas, so this check is considerably cheaper.
+ *
+ * return values:
+ * 0 : O.k, deployed to address_out
+ * 1 : O.k, code already existed at address_out and create2 was skipped
+ * -1 : create2 failed. *revert_data_len is set, data can be read via read_return_data
+ */
+int create2_factory_deploy(create2_factory *factory, const uint8_t *endowment, bebi32 const salt,
+                           uint8_t *address_out, size_t *revert_data_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __DEPLOY_H
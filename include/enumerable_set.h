@@ -0,0 +1,139 @@
+#ifndef __ENUMERABLE_SET_H
+#define __ENUMERABLE_SET_H
+
+/**
+ * enumerable_set.h keeps a set of 32-byte values in storage with O(1) add, remove and
+ * contains, and enumeration without holes
+ *
+ * The layout is that of OpenZeppelin's EnumerableSet:
+ *     bytes32[] values;                      // values_slot
+ *     mapping(bytes32 => uint256) positions; // positions_slot
+ * where positions[v] is the index of v in values plus one, and 0 if v is not in the set.
+ * Removal moves the last value into the freed index and pops the array, so values never has
+ * holes. Addresses are stored padded to 32 bytes, as OpenZeppelin's AddressSet does.
+ *
+ * Layouts that reserve the first entries of the array (e.g. a blank entry at index 0, with
+ * positions holding the plain index) are supported with "reserved": positions[v] is then
+ * index + 1 - reserved, and reserved entries are never moved or counted. While the array is
+ * shorter than reserved the set is empty, and the first add sets the length past the reserved
+ * entries without writing them, as a solidity push of blank entries would leave them zero.
+ *
+ * Storage cost per operation:
+ *  * contains:             1 SLOAD
+ *  * length:               1 SLOAD
+ *  * add (new value):      2 SLOADs + 3 SSTOREs, 1 SLOAD if already present
+ *  * remove (last value):  2 SLOADs + 3 SSTOREs
+ *  * remove (other value): 3 SLOADs + 5 SSTOREs, 1 SLOAD if not present
+ *  * enumeration:          1 SLOAD for the length, then 1 SLOAD per value
+ * No keccak is computed per enumerated value: a cursor steps the slot of the values in place.
+ *
+ * requires: bebi.h(string.h), storage.h, hostio.h
+ * c-file: enumerable_set.c
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <bebi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * values_slot: slot of the array (holds its length)
+ * values_base: keccak256(values_slot), where the values start
+ * positions_slot: slot of the positions mapping
+ * reserved: leading array entries that are not part of the set
+ */
+typedef struct enumerable_set {
+    bebi32 values_slot;
+    bebi32 values_base;
+    bebi32 positions_slot;
+    uint64_t reserved;
+} enumerable_set;
+
+/**
+ * a set with its own layout, e.g. from cargo-stylus defines:
+ *
+ * enumerable_set minters = ENUMERABLE_SET_INIT(STORAGE_SLOT_minters, STORAGE_BASE_minters,
+ *                                              STORAGE_SLOT_minter_idx, 1);
+ */
+#define ENUMERABLE_SET_INIT(values_slot_init, values_base_init, positions_slot_init, reserved_init) \
+    {                                                                                           \
+        .values_slot = values_slot_init, .values_base = values_base_init,                       \
+        .positions_slot = positions_slot_init, .reserved = (reserved_init),                     \
+    }
+
+/**
+ * the set of an OpenZeppelin EnumerableSet.Bytes32Set/AddressSet/UintSet declared at "slot"
+ * (values at slot, positions at slot + 1)
+ */
+void enumerable_set_init(enumerable_set *set, bebi32 const slot);
+
+/**
+ * value: 32 bytes, padded as stored
+ */
+bool enumerable_set_contains(const enumerable_set *set, const uint8_t *value);
+
+/**
+ * number of values in the set (reserved entries excluded)
+ */
+uint64_t enumerable_set_length(const enumerable_set *set);
+
+/**
+ * return values:
+ * 0 : value was already in the set
+ * 1 : value added
+ */
+int enumerable_set_add(const enumerable_set *set, const uint8_t *value);
+
+/**
+ * return values:
+ * 0 : value was not in the set
+ * 1 : value removed. The last value took its index
+ */
+int enumerable_set_remove(const enumerable_set *set, const uint8_t *value);
+
+/**
+ * reads the value at index (0 <= index < length) to out
+ * returns -1 if index is out of bounds, 0 otherwise
+ */
+int enumerable_set_at(const enumerable_set *set, uint64_t index, uint8_t *out);
+
+/**
+ * Reads values in order. Fields are private.
+ *
+ * enumerable_set_cursor cursor;
+ * enumerable_set_cursor_init(&cursor, &set, 0);
+ * bebi32 value;
+ * while (enumerable_set_next(&cursor, value)) { ... }
+ *
+ * The set must not change while a cursor reads it.
+ */
+typedef struct enumerable_set_cursor {
+    bebi32 slot;
+    uint64_t remaining;
+} enumerable_set_cursor;
+
+/**
+ * positions cursor at index "start", loading the length once
+ */
+void enumerable_set_cursor_init(enumerable_set_cursor *cursor, const enumerable_set *set, uint64_t start);
+
+/**
+ * reads the next value to out, returns false when no values are left
+ */
+bool enumerable_set_next(enumerable_set_cursor *cursor, uint8_t *out);
+
+/**
+ * reads up to max values starting at index "start" into out (32 bytes each)
+ * returns the number of values read
+ */
+size_t enumerable_set_values(const enumerable_set *set, uint64_t start, uint8_t *out, size_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __ENUMERABLE_SET_H
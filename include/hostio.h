@@ -11,7 +11,12 @@
 extern "C" {
 #endif
 
+#ifdef __wasm__
 #define VM_HOOK(name) extern __attribute__((import_module("vm_hooks"), import_name(#name)))
+#else
+// native builds link against a host implementation, such as the simulator in sim/
+#define VM_HOOK(name) extern
+#endif
 
 /**
  * Gets the ETH balance in wei of the account at the given address.
@@ -362,8 +367,23 @@ VM_HOOK(tx_ink_price) uint64_t tx_ink_price();
  */
 VM_HOOK(tx_origin) void tx_origin(uint8_t * origin);
 
+/**
+ * Applies X to the name of every hostio above, in order.
+ */
+#define STYLUS_HOSTIOS(X) \
+    X(account_balance) X(account_codehash) X(storage_load_bytes32) X(storage_store_bytes32) \
+    X(block_basefee) X(chainid) X(block_coinbase) X(block_gas_limit) X(block_number) \
+    X(block_timestamp) X(call_contract) X(contract_address) X(create1) X(create2) \
+    X(delegate_call_contract) X(emit_log) X(evm_gas_left) X(evm_ink_left) X(memory_grow) \
+    X(msg_sender) X(msg_value) X(native_keccak256) X(read_args) X(read_return_data) \
+    X(write_result) X(return_data_size) X(static_call_contract) X(tx_gas_price) \
+    X(tx_ink_price) X(tx_origin)
+
 #ifdef __cplusplus
 }
 #endif
 
+// with STYLUS_TRACE defined, wraps the hostios above with counters
+#include "stylus_trace.h"
+
 #endif
@@ -0,0 +1,141 @@
+#ifndef __KECCAK_H
+#define __KECCAK_H
+
+/**
+ * keccak.h implements keccak256 inside the wasm, as an alternative to the native_keccak256 hostio
+ *
+ * Every hostio call has a fixed overhead. For short inputs the in-wasm permutation may be cheaper,
+ * while for longer inputs the hostio wins. keccak256() picks between the two by input length.
+ * The cutoff is set when keccak.c is compiled: define KECCAK256_WASM_BELOW there (e.g.
+ * -DKECCAK256_WASM_BELOW=64) so that inputs shorter than that many bytes are hashed in-wasm.
+ * By default it is 0 and keccak256() always uses the hostio. Other files read the cutoff at
+ * link time through keccak256_wasm_below, so every inlined copy of keccak256() follows the
+ * same policy whatever each file was compiled with.
+ *
+ * bench/keccak measures the ink cost of both paths across input sizes, and can be used to
+ * pick the cutoff for a specific chain.
+ *
+ * The sponge api also allows absorbing input incrementally, and squeezing any output length.
+ * The hasher api hashes a message given in several pieces, on the path keccak256() would take.
+ *
+ * requires: hostio.h, string.h
+ * c-file: keccak.c
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <hostio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * inputs shorter than this are hashed in-wasm: KECCAK256_WASM_BELOW as keccak.c was compiled
+ */
+extern const size_t keccak256_wasm_below;
+
+// keccak256 absorbs 136 bytes per permutation
+#define KECCAK256_RATE 136
+
+/**
+ * applies the keccak-f[1600] permutation to the state
+ */
+void keccak_f1600(uint64_t state[25]);
+
+/**
+ * keccak256 sponge. Fields are private, use the functions below.
+ */
+typedef struct keccak_sponge {
+    uint64_t state[25];
+    size_t pos;
+    bool squeezing;
+} keccak_sponge;
+
+void keccak_sponge_init(keccak_sponge *sponge);
+
+/**
+ * absorb more input. Must not be called after squeezing started.
+ */
+void keccak_sponge_absorb(keccak_sponge *sponge, const uint8_t *data, size_t len);
+
+/**
+ * squeeze output. The first call pads and finalizes the input,
+ * squeezing 32 bytes once yields the keccak256 hash.
+ */
+void keccak_sponge_squeeze(keccak_sponge *sponge, uint8_t *out, size_t len);
+
+/**
+ * true if keccak256() hashes len bytes in-wasm, false if it calls the hostio
+ */
+inline bool keccak256_in_wasm(size_t len) {
+    return len < keccak256_wasm_below;
+}
+
+/**
+ * Streaming keccak256 hasher: init, update with any number of pieces, final.
+ *
+ * init is given the total message length, and picks the same path as keccak256() would:
+ *  * in-wasm: every piece is absorbed straight into the keccak state. Nothing is copied,
+ *    and no buffer is needed (buf may be NULL).
+ *  * hostio: native_keccak256 hashes one contiguous buffer, so the pieces are copied into
+ *    the caller's buffer and hashed once at final. That copy is the price of the hostio,
+ *    which is still the cheaper path for these lengths. The buffer must hold the whole
+ *    message: an update that does not fit fails, and so does final.
+ *
+ * uint8_t buf[64];
+ * keccak256_hasher hasher;
+ * keccak256_init(&hasher, 64, buf, sizeof(buf));
+ * keccak256_update(&hasher, key, 32);
+ * keccak256_update(&hasher, slot, 32);
+ * keccak256_final(&hasher, out);
+ *
+ * Fields are private, use the functions below.
+ */
+typedef struct keccak256_hasher {
+    bool in_wasm;
+    bool overflow;
+    uint8_t *buf;
+    size_t cap;
+    size_t len;
+    keccak_sponge sponge;
+} keccak256_hasher;
+
+/**
+ * len: total length of the message, selects the path
+ * buf, cap: buffer for the hostio path, at least len bytes. Unused if keccak256_in_wasm(len)
+ */
+void keccak256_init(keccak256_hasher *hasher, size_t len, uint8_t *buf, size_t cap);
+
+/**
+ * returns -1 if data does not fit in the buffer, 0 otherwise
+ */
+int keccak256_update(keccak256_hasher *hasher, const uint8_t *data, size_t len);
+
+/**
+ * returns -1 (output untouched) if an update did not fit, 0 otherwise
+ */
+int keccak256_final(keccak256_hasher *hasher, uint8_t *output);
+
+/**
+ * computes keccak256 in wasm (never calls the hostio)
+ */
+void keccak256_wasm(const uint8_t *data, size_t len, uint8_t *output);
+
+/**
+ * computes keccak256, in wasm if len < keccak256_wasm_below and using the hostio otherwise
+ */
+inline void keccak256(const uint8_t *data, size_t len, uint8_t *output) {
+    if (keccak256_in_wasm(len)) {
+        keccak256_wasm(data, len, output);
+    } else {
+        native_keccak256(data, len, output);
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __KECCAK_H
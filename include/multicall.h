@@ -0,0 +1,75 @@
+#ifndef __MULTICALL_H
+#define __MULTICALL_H
+
+/**
+ * multicall.h executes a batch of sub-calls from a single place
+ *
+ * Results are written in the same ABI as the return value of Multicall3's aggregate3:
+ * (bool success, bytes returnData)[]
+ * so a batch can be returned as-is by a function declared to return Multicall3.Result[].
+ *
+ * Return data of each call is read straight into its final position in the output buffer,
+ * no intermediate copy is made.
+ *
+ * requires: bebi.h(string.h), hostio.h
+ * c-file: multicall.c
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A single call in the batch
+ *
+ * target: 20-byte address
+ * value: 32-byte big-endian wei, or NULL to send no value. Must be NULL for static batches
+ * gas: passed as-is to the hostio. u64::MAX sends as much as possible (63/64 rule applies)
+ * allow_failure: if false, a failing call aborts the batch
+ */
+typedef struct multicall_call {
+    const uint8_t *target;
+    const uint8_t *calldata;
+    size_t calldata_len;
+    const uint8_t *value;
+    uint64_t gas;
+    bool allow_failure;
+} multicall_call;
+
+/**
+ * Returns an upper bound on the output bytes needed to hold results of "count" calls
+ * returning a total of "return_data_len" bytes (before padding)
+ */
+size_t multicall_output_size(size_t count, size_t return_data_len);
+
+/**
+ * Executes "count" calls in order, using static_call_contract if is_static is set
+ * and call_contract otherwise.
+ *
+ * On success, *out_len_out is set to the number of bytes written to out.
+ *
+ * A static batch with a value, or an out_cap too small for the headers of all results,
+ * fails before any call is made. Return data sizes are only known once each call returns:
+ * if they overflow out_cap, multicall returns -1 after the earlier calls have executed,
+ * and their effects are kept. The caller must then revert. Size out with
+ * multicall_output_size for the largest return data expected.
+ *
+ * return values:
+ * -1 : ERROR out_cap too small for the results (or a value was given in a static batch).
+ *      Calls may already have executed: revert
+ * 0 : O.k
+ * 1 : a call with allow_failure == false failed. *out_len_out is the index of that call,
+ *     its revert data can still be read via read_return_data
+ */
+int multicall(const multicall_call *calls, size_t count, bool is_static,
+              uint8_t *out, size_t out_cap, size_t *out_len_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __MULTICALL_H
@@ -0,0 +1,108 @@
+#ifndef __PACKED_H
+#define __PACKED_H
+
+/**
+ * packed.h decodes compact (non-ABI) calldata
+ *
+ * On Arbitrum every calldata byte is posted to L1, and ABI encoding pads every value to
+ * 32 bytes. The packed encoding keeps only the bytes that carry information:
+ *  * varint:  unsigned LEB128, 1 byte for values below 128, up to 10 bytes for a u64
+ *  * address: 20 bytes
+ *  * uint:    1 length byte (0..32), then that many big-endian bytes without leading zeros
+ *  * bytes:   raw bytes of a length known to the caller (e.g. a preceding varint)
+ * e.g. transfer(0x1234...5678, 10**18) is 1 + 20 + 1 + 8 = 30 bytes, instead of 4 + 64.
+ *
+ * Values are decoded straight from the args buffer into bebi32, addresses zero-padded
+ * so they can be used as map keys directly.
+ *
+ * A reader keeps a sticky error: fields can be read one after the other, and checked once
+ * with packed_end, which also requires all input to be consumed.
+ *
+ * Packed calls are dispatched by their first byte, an index into a table of handlers:
+ * PACKED_ENTRYPOINT for contracts that only take packed calls, or packed_dispatch from
+ * the default function of an ABI contract (see examples/erc20).
+ * tools/lib/packed.js encodes packed calls for clients and tests.
+ *
+ * requires: bebi.h(string.h), stylus_types.h, stylus_entry.h (for PACKED_ENTRYPOINT)
+ * c-file: packed.c
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <bebi.h>
+#include <stylus_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct packed_reader {
+    const uint8_t *data;
+    size_t len;
+    size_t pos;
+    bool error;
+} packed_reader;
+
+void packed_reader_init(packed_reader *reader, const uint8_t *data, size_t len);
+
+/**
+ * read functions return 0 on success, and -1 if the input is short or malformed.
+ * After an error every read fails, and outputs are left unchanged.
+ */
+int packed_read_u8(packed_reader *reader, uint8_t *out);
+int packed_read_varint(packed_reader *reader, uint64_t *out);
+int packed_read_address(packed_reader *reader, bebi32 out);
+int packed_read_uint(packed_reader *reader, bebi32 out);
+
+/**
+ * points out at the next len bytes of input, without copying them
+ */
+int packed_read_bytes(packed_reader *reader, size_t len, const uint8_t **out);
+
+/**
+ * returns 0 if every read succeeded and all input was consumed, -1 otherwise
+ */
+int packed_end(const packed_reader *reader);
+
+/**
+ * write functions encode into out, which must have room for the encoded value,
+ * and return the number of bytes written
+ * (varint: at most 10 bytes, address: 20, uint: at most 33)
+ */
+size_t packed_write_varint(uint8_t *out, uint64_t val);
+size_t packed_write_address(uint8_t *out, const uint8_t *address);
+size_t packed_write_uint(uint8_t *out, bebi32 const val);
+
+/**
+ * handles one packed call. args is positioned after the method byte.
+ * Call packed_end before making changes, to reject malformed input.
+ */
+typedef ArbResult (*packed_handler)(void *storage, packed_reader *args);
+
+/**
+ * calls handlers[args[0]] with the rest of args
+ * returns a Failure without data if args is empty or the method is out of range
+ */
+ArbResult packed_dispatch(void *storage, const packed_handler *handlers, size_t count, const uint8_t *args,
+                          size_t len);
+
+/**
+ * An ENTRYPOINT without function selectors: the first byte of args selects the handler.
+ *
+ * static const packed_handler handlers[] = { packed_transfer, packed_mint };
+ * PACKED_ENTRYPOINT(handlers)
+ */
+#define PACKED_ENTRYPOINT(handlers)                                                            \
+    static ArbResult handlers##_packed_main(uint8_t *args, size_t args_len) {                  \
+        return packed_dispatch(NULL, handlers, sizeof(handlers) / sizeof(handlers[0]), args,   \
+                               args_len);                                                      \
+    }                                                                                          \
+                                                                                               \
+    ENTRYPOINT(handlers##_packed_main)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __PACKED_H
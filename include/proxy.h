@@ -0,0 +1,97 @@
+#ifndef __PROXY_H
+#define __PROXY_H
+
+/**
+ * proxy.h forwards every call to an implementation contract with delegate_call_contract
+ *
+ * The implementation address is kept in the EIP-1967 implementation slot
+ * (keccak256("eip1967.proxy.implementation") - 1), so explorers and tools recognize the
+ * proxy, and an implementation sharing the proxy's storage never collides with it.
+ *
+ * PROXY_ENTRYPOINT reads args once and hands that buffer as-is to delegate_call_contract.
+ * All return data is read with one read_return_data into a single buffer (the args buffer
+ * when it is large enough) and passed to write_result, whether the call succeeded or
+ * reverted. Both buffers are on the heap (malloc), never on the stack: their lengths are
+ * chosen by the caller and the implementation, and may be larger than the wasm stack.
+ *
+ * The proxy itself has no functions: upgrades are made by the implementation (the UUPS
+ * pattern), which calls proxy_set_implementation while running in the proxy's storage.
+ *
+ * requires: bebi.h(string.h), hostio.h, selectors.h, stdlib.h (malloc), stylus_entry.h (for PROXY_ENTRYPOINT)
+ * c-file: proxy.c
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stylus_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PROXY_IMPLEMENTATION_SLOT                                                              \
+    {                                                                                          \
+        0x36, 0x08, 0x94, 0xa1, 0x3b, 0xa1, 0xa3, 0x21,                                        \
+        0x06, 0x67, 0xc8, 0x28, 0x49, 0x2d, 0xb9, 0x8d,                                        \
+        0xca, 0x3e, 0x20, 0x76, 0xcc, 0x37, 0x35, 0xa9,                                        \
+        0x20, 0xa3, 0xca, 0x50, 0x5d, 0x38, 0x2b, 0xbc,                                        \
+    }
+
+/**
+ * reads the implementation address (20 bytes) from the EIP-1967 slot
+ * returns false if none is set
+ */
+bool proxy_implementation(uint8_t *implementation);
+
+/**
+ * stores the implementation address and emits the EIP-1967 Upgraded(address) event
+ */
+void proxy_set_implementation(const uint8_t *implementation);
+
+/**
+ * called by a proxy with no implementation set, typically to validate the caller
+ * and call proxy_set_implementation
+ */
+typedef ArbResult (*proxy_init_handler)(uint8_t *args, size_t args_len);
+
+/**
+ * delegate calls the implementation with args, and writes all its return data as the result.
+ * Calls init_main instead, and writes its result, if no implementation is set.
+ * args is overwritten by return data when it fits.
+ * returns the status for user_entrypoint: 0 on success, 1 on revert
+ */
+int proxy_forward(uint8_t *args, size_t args_len, proxy_init_handler init_main);
+
+/**
+ * The entrypoint of a proxy contract.
+ * init_main handles calls until an implementation is set (see proxy_init_handler).
+ *
+ * PROXY_ENTRYPOINT(proxy_init)
+ */
+#define PROXY_ENTRYPOINT(init_main)                                     \
+    /* Force the compiler to import these symbols                    */ \
+    /* Note: calling these functions will unproductively consume gas */ \
+    STYLUS_EXPORT(mark_used)                                            \
+    void mark_used() {                                                  \
+        memory_grow(0);                                                 \
+    }                                                                   \
+                                                                        \
+    STYLUS_EXPORT(user_entrypoint)                                      \
+    int user_entrypoint(size_t args_len) {                              \
+        STYLUS_TRACE_RESET();                                           \
+        STYLUS_PROFILE_RESET();                                         \
+        uint8_t *args = malloc(args_len);                               \
+        read_args(args);                                                \
+        const int status = proxy_forward(args, args_len, init_main);    \
+        STYLUS_TRACE_DUMP();                                            \
+        STYLUS_PROFILE_DUMP();                                          \
+        return status;                                                  \
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __PROXY_H
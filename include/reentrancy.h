@@ -0,0 +1,138 @@
+#ifndef __REENTRANCY_H
+#define __REENTRANCY_H
+
+/**
+ * reentrancy.h guards a contract against reentrant calls, touching storage as little as possible
+ *
+ * The lock flag is a single byte packed into a slot the contract already uses, e.g. a bool
+ * declared next to other small fields:
+ *     address owner; bool locked;  // STORAGE_SLOT_locked, STORAGE_END_OFFSET_locked
+ * The slot is loaded once on entry, and the loaded value is kept in the guard so the
+ * other fields of that slot can be read from it without a second SLOAD.
+ *
+ * The flag is only written to storage before an external call, since only an external
+ * call can reenter. Storage cost per guarded entrypoint:
+ *  * no external call: 1 SLOAD, which the contract would often pay for the packed fields anyway
+ *  * any number of external calls: 3 SLOADs + 2 SSTOREs. The second SSTORE restores the
+ *    original value of the slot, so most of the first one is refunded (EIP-2200), and the
+ *    last two SLOADs are warm
+ *
+ * Both writes of the flag (before the first external call, and on exit) reload the slot
+ * first, and only change the flag byte. Writes to the other fields of the slot made after
+ * entry are kept, whether made by the handler (with storage_store_bytes32 or
+ * reentrancy_store_slot) or by the callee of a delegate call, which runs in this
+ * contract's storage.
+ *
+ * Static calls cannot change state, and are not guarded.
+ * A reverted call rolls the flag back with the rest of storage, so failure paths need no cleanup.
+ *
+ * requires: bebi.h(string.h), hostio.h, stylus_entry.h (for GUARDED_ENTRYPOINT)
+ * c-file: reentrancy.c
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <bebi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * slot: the storage slot holding the flag
+ * flag_offset: byte of the flag within the slot (STORAGE_END_OFFSET of the flag field - 1)
+ * value: the slot as last loaded or stored, flag included
+ * locked_in_storage: the flag was set in storage by reentrancy_call_begin
+ */
+typedef struct reentrancy_guard {
+    bebi32 slot;
+    size_t flag_offset;
+    bebi32 value;
+    bool locked_in_storage;
+} reentrancy_guard;
+
+/**
+ * static initializer, e.g:
+ * reentrancy_guard guard = REENTRANCY_GUARD_INIT(STORAGE_SLOT_locked, STORAGE_END_OFFSET_locked);
+ */
+#define REENTRANCY_GUARD_INIT(slot_init, end_offset) REENTRANCY_GUARD_INIT_SLOT_LAST(end_offset, slot_init)
+
+// the slot comes last, so a braced slot initializer that was already expanded by an
+// enclosing macro (e.g. GUARDED_ENTRYPOINT) is taken whole despite its commas
+#define REENTRANCY_GUARD_INIT_SLOT_LAST(end_offset, ...) \
+    { .slot = __VA_ARGS__, .flag_offset = (end_offset) - 1, .value = {0}, .locked_in_storage = false }
+
+/**
+ * loads the slot holding the flag
+ * returns 0 on success, -1 if the flag is set (this is a reentrant call)
+ */
+int reentrancy_enter(reentrancy_guard *guard);
+
+/**
+ * call before each external call (call_contract, delegate_call_contract, create1, create2)
+ * writes the flag to storage on the first call only, reloading the slot first (a warm SLOAD)
+ */
+void reentrancy_call_begin(reentrancy_guard *guard);
+
+/**
+ * clears the flag in storage, if it was written
+ * reloads the slot first (a warm SLOAD), and only changes the flag byte
+ */
+void reentrancy_exit(reentrancy_guard *guard);
+
+/**
+ * the slot holding the flag, as last loaded or stored by the guard. Other fields packed
+ * in the slot may be read from it directly, e.g. bebi_get_u64(reentrancy_slot(guard), offset)
+ * It does not see writes to the slot made since then, e.g. by the callee of a delegate call
+ */
+inline const uint8_t *reentrancy_slot(const reentrancy_guard *guard) {
+    return guard->value;
+}
+
+/**
+ * stores a new value of the slot holding the flag, keeping the flag as it is in storage
+ * (reloaded with a warm SLOAD). Use it to update other fields packed in the slot
+ */
+void reentrancy_store_slot(reentrancy_guard *guard, bebi32 const value);
+
+/**
+ * call_contract and delegate_call_contract, preceded by reentrancy_call_begin
+ */
+uint8_t reentrancy_call_contract(reentrancy_guard *guard, const uint8_t *contract, const uint8_t *calldata,
+                                 size_t calldata_len, const uint8_t *value, uint64_t gas, size_t *return_data_len);
+uint8_t reentrancy_delegate_call_contract(reentrancy_guard *guard, const uint8_t *contract, const uint8_t *calldata,
+                                          size_t calldata_len, uint64_t gas, size_t *return_data_len);
+
+/**
+ * guard used by GUARDED_ENTRYPOINT
+ */
+extern reentrancy_guard stylus_guard;
+
+/**
+ * An ENTRYPOINT that rejects reentrant calls.
+ * user_main makes its external calls through stylus_guard, e.g.
+ *     reentrancy_call_contract(&stylus_guard, ...)
+ *
+ * GUARDED_ENTRYPOINT(user_main, STORAGE_SLOT_locked, STORAGE_END_OFFSET_locked)
+ */
+#define GUARDED_ENTRYPOINT(user_main, slot_init, end_offset)                              \
+    reentrancy_guard stylus_guard =                                                       \
+        REENTRANCY_GUARD_INIT_SLOT_LAST(end_offset, slot_init);                           \
+                                                                                          \
+    static ArbResult user_main##_guarded(uint8_t *args, size_t args_len) {                \
+        if (reentrancy_enter(&stylus_guard) != 0) {                                       \
+            return (ArbResult){ .status = Failure, .output = NULL, .output_len = 0 };     \
+        }                                                                                 \
+        const ArbResult result = user_main(args, args_len);                               \
+        reentrancy_exit(&stylus_guard);                                                   \
+        return result;                                                                    \
+    }                                                                                     \
+                                                                                          \
+    ENTRYPOINT(user_main##_guarded)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __REENTRANCY_H
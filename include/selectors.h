@@ -0,0 +1,15 @@
+// generated by tools/selectors.js, do not edit
+
+#ifndef __SELECTORS_H
+#define __SELECTORS_H
+
+// Error(string)
+#define SELECTOR_Error 0x08c379a0
+#define SELECTOR_BYTES_Error {0x08, 0xc3, 0x79, 0xa0}
+// Panic(uint256)
+#define SELECTOR_Panic 0x4e487b71
+#define SELECTOR_BYTES_Panic {0x4e, 0x48, 0x7b, 0x71}
+// Upgraded(address)
+#define TOPIC_Upgraded {0xbc, 0x7c, 0xd7, 0x5a, 0x20, 0xee, 0x27, 0xfd, 0x9a, 0xde, 0xba, 0xb3, 0x20, 0x41, 0xf7, 0x55, 0x21, 0x4d, 0xbc, 0x6b, 0xff, 0xa9, 0x0c, 0xc0, 0x22, 0x5b, 0x39, 0xda, 0x2e, 0x5c, 0x2d, 0x3b}
+
+#endif // __SELECTORS_H
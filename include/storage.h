@@ -4,6 +4,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <bebi.h>
 #include <hostio.h>
 
@@ -13,7 +14,7 @@
  * These user is still required to understand solidity storage and use accordingly
  * See: https://docs.soliditylang.org/en/v0.8.20/internals/layout_in_storage.html
  *
- * requires: bebi.h (string.h)
+ * requires: bebi.h (string.h), keccak.h
  * c-file: storage.c
  */
 
@@ -48,6 +49,13 @@ inline void storage_store(void *storage, const uint8_t *key, const uint8_t *valu
  */
 void map_slot(bebi32 const storage, uint8_t const *key, size_t key_len, bebi32 slot_out);
 
+/**
+ * calculate slot for a chain of nested maps, e.g. mapping(address => mapping(address => uint256))
+ * keys[0] is the key of the outermost map. All keys must be padded to 32 bytes.
+ * equivalent to calling map_slot for each key in turn, using a single hashing buffer.
+ */
+void map_slot_path(bebi32 const base, uint8_t const *const keys[], size_t n, bebi32 slot_out);
+
 /**
  * calculate slot and offset for an array with base slot "slot"
  * notice tht short byte-arrays and strings are not stored in base but in
@@ -57,10 +65,56 @@ int array_slot_offset(bebi32 const base, size_t val_size, uint64_t index, bebi32
 
 /**
  * calculate the base slot for a dynamic array with storage-slot "storage"
- * (this is just native keccak of storage into base_out)
+ * (this is just keccak of storage into base_out)
  */
 void dynamic_array_base_slot(bebi32 const storage, bebi32 base_out);
 
+/**
+ * storage_bitmap_* pack 256 boolean flags per slot, e.g. for airdrop claims or used nonces.
+ *
+ * The layout is that of OpenZeppelin's BitMaps, a mapping(uint256 => uint256) at slot "base":
+ * flag "index" is bit (index & 0xff) of the value at key (index >> 8).
+ * Indexes are u64 here.
+ *
+ * get: 1 SLOAD. set / clear: 1 SLOAD, and 1 SSTORE only if the flag changes.
+ */
+void storage_bitmap_slot(bebi32 const base, uint64_t index, bebi32 slot_out);
+
+bool storage_bitmap_get(bebi32 const base, uint64_t index);
+
+/**
+ * set the flag to value
+ * returns 1 if the flag changed, 0 if it already had that value
+ */
+int storage_bitmap_set_to(bebi32 const base, uint64_t index, bool value);
+
+/**
+ * storage_bitmap_set_to with value true / false
+ */
+int storage_bitmap_set(bebi32 const base, uint64_t index);
+int storage_bitmap_clear(bebi32 const base, uint64_t index);
+
+/**
+ * set flags [start, start + count) to value.
+ * Slots covered entirely are stored without being loaded, the (at most 2) partial slots
+ * cost 1 SLOAD and 1 SSTORE if they change.
+ * returns -1 (nothing stored) if the range goes past index UINT64_MAX, 0 otherwise
+ */
+int storage_bitmap_set_range(bebi32 const base, uint64_t start, uint64_t count, bool value);
+
+/**
+ * number of flags set in [start, start + count), 1 SLOAD per slot covered
+ * a range going past index UINT64_MAX is cut there
+ */
+uint64_t storage_bitmap_count(bebi32 const base, uint64_t start, uint64_t count);
+
+/**
+ * set the flags of n indexes to value, loading each slot once and storing it once if it changed.
+ * indexes are sorted in place (duplicates allowed).
+ * returns the number of flags that changed, e.g. less than n if a claim was already made.
+ */
+size_t storage_bitmap_set_batch(bebi32 const base, uint64_t *indexes, size_t n, bool value);
+
 #ifdef __cplusplus
 }
 #endif
@@ -28,6 +28,7 @@ inline void *memset(void *ptr, int value, size_t num) {
     return __builtin_memset(ptr, value, num);
 }
 
+int memcmp(const void *ptr1, const void *ptr2, size_t num);
 char *strncpy(char *dst, const char *src, size_t num);
 size_t strlen(const char *str);
 
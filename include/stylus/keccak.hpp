@@ -0,0 +1,161 @@
+#ifndef __STYLUS_KECCAK_HPP
+#define __STYLUS_KECCAK_HPP
+
+/**
+ * stylus/keccak.hpp computes keccak256, function selectors and event topics at compile time
+ * (C++17 or newer, header only)
+ *
+ *     switch (bebi_get_u32(args, 0)) {
+ *     case selector("transfer(address,uint256)"): ...
+ *     }
+ *     constexpr Bytes32 transfer_topic = topic("Transfer(address,address,uint256)");
+ *
+ * With C++20 selector() and topic() are consteval, so they never hash at runtime.
+ * keccak256() is constexpr, and hashes in-wasm if called with runtime data: use keccak.h
+ * for that instead.
+ *
+ * Signatures must be canonical, as solidity hashes them: no spaces or argument names,
+ * uint256 rather than uint. C code can get the same constants from tools/selectors.js.
+ *
+ * requires: stylus/types.hpp
+ * c-file: -
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stylus/types.hpp>
+
+#if defined(__cpp_consteval)
+#define STYLUS_CONSTEVAL consteval
+#else
+#define STYLUS_CONSTEVAL constexpr
+#endif
+
+namespace stylus {
+
+namespace detail {
+
+constexpr uint64_t keccak_round_constants[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+};
+
+// rho rotations, in the order lanes are visited by pi
+constexpr uint8_t keccak_rotations[24] = {
+    1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44,
+};
+
+// pi lane order
+constexpr uint8_t keccak_pi_lanes[24] = {
+    10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1,
+};
+
+constexpr uint64_t rotl64(uint64_t x, int b) {
+    return (x << b) | (x >> (64 - b));
+}
+
+// same permutation as keccak_f1600 in src/keccak.c
+constexpr void keccak_f1600(uint64_t state[25]) {
+    for (int round = 0; round < 24; round++) {
+        uint64_t bc[5] = {0};
+        // theta
+        for (int i = 0; i < 5; i++) {
+            bc[i] = state[i] ^ state[i + 5] ^ state[i + 10] ^ state[i + 15] ^ state[i + 20];
+        }
+        for (int i = 0; i < 5; i++) {
+            uint64_t t = bc[(i + 4) % 5] ^ rotl64(bc[(i + 1) % 5], 1);
+            for (int j = 0; j < 25; j += 5) {
+                state[j + i] ^= t;
+            }
+        }
+        // rho and pi
+        uint64_t t = state[1];
+        for (int i = 0; i < 24; i++) {
+            int j = keccak_pi_lanes[i];
+            uint64_t next = state[j];
+            state[j] = rotl64(t, keccak_rotations[i]);
+            t = next;
+        }
+        // chi
+        for (int j = 0; j < 25; j += 5) {
+            for (int i = 0; i < 5; i++) {
+                bc[i] = state[j + i];
+            }
+            for (int i = 0; i < 5; i++) {
+                state[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
+            }
+        }
+        // iota
+        state[0] ^= keccak_round_constants[round];
+    }
+}
+
+// lanes are little endian
+constexpr void keccak_xor_byte(uint64_t state[25], size_t pos, uint8_t val) {
+    state[pos / 8] ^= (uint64_t)val << (8 * (pos % 8));
+}
+
+}  // namespace detail
+
+/**
+ * keccak256 of len bytes. Works on char data, so string literals can be hashed in constant expressions.
+ */
+template <typename Byte>
+constexpr Bytes32 keccak256(const Byte *data, size_t len) {
+    static_assert(sizeof(Byte) == 1, "keccak256 hashes bytes");
+    const size_t rate = 136;
+    uint64_t state[25] = {0};
+    size_t pos = 0;
+    for (size_t i = 0; i < len; i++) {
+        detail::keccak_xor_byte(state, pos, (uint8_t)data[i]);
+        pos++;
+        if (pos == rate) {
+            detail::keccak_f1600(state);
+            pos = 0;
+        }
+    }
+    // keccak padding (not SHA3): 0x01 .. 0x80
+    detail::keccak_xor_byte(state, pos, 0x01);
+    detail::keccak_xor_byte(state, rate - 1, 0x80);
+    detail::keccak_f1600(state);
+    Bytes32 res{};
+    for (size_t i = 0; i < 32; i++) {
+        res.bytes[i] = (uint8_t)(state[i / 8] >> (8 * (i % 8)));
+    }
+    return res;
+}
+
+/**
+ * keccak256 of a string literal, without its terminating zero
+ */
+template <size_t N>
+constexpr Bytes32 keccak256(const char (&str)[N]) {
+    return keccak256(str, N - 1);
+}
+
+/**
+ * 4-byte function selector of a canonical signature, as a big-endian u32
+ * (compare with bebi_get_u32(args, 0))
+ */
+template <size_t N>
+STYLUS_CONSTEVAL uint32_t selector(const char (&signature)[N]) {
+    Bytes32 hash = keccak256(signature, N - 1);
+    return ((uint32_t)hash.bytes[0] << 24) | ((uint32_t)hash.bytes[1] << 16) | ((uint32_t)hash.bytes[2] << 8) |
+           (uint32_t)hash.bytes[3];
+}
+
+/**
+ * topic of an event (its first indexed topic, topic0) from its canonical signature
+ */
+template <size_t N>
+STYLUS_CONSTEVAL Bytes32 topic(const char (&signature)[N]) {
+    return keccak256(signature, N - 1);
+}
+
+}  // namespace stylus
+
+#endif  // __STYLUS_KECCAK_HPP
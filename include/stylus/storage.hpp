@@ -0,0 +1,457 @@
+#ifndef __STYLUS_STORAGE_HPP
+#define __STYLUS_STORAGE_HPP
+
+/**
+ * stylus/storage.hpp is a typed C++ layer over storage.h (C++17 or newer, header only)
+ *
+ * Declares contract storage with the layout solc reports in storageLayout:
+ *
+ *     // uint256 _totalSupply;  uint64 minters_current; bool initialized;
+ *     // mapping(address => uint256) _balances;  address[] minters;
+ *     constexpr StorageValue<Bytes32, 0> total_supply;
+ *     constexpr StorageValue<uint64_t, 1, 0> minters_current;
+ *     constexpr StorageValue<bool, 1, 8> initialized;
+ *     constexpr StorageMap<Address, Bytes32> balances{4};
+ *     constexpr StorageArray<Address> minters{2};
+ *
+ *     balances[owner].set(amount);
+ *     uint64_t n = minters_current.get();
+ *
+ * Offsets are solidity's: bytes from the low-order (right) end of the slot.
+ * The generated STORAGE_END_OFFSET_x is 32 - offset - sizeof(x).
+ *
+ * Slots and byte positions are computed at compile time. At runtime only the
+ * keccaks that solidity's layout requires remain (one per map key, one per array base).
+ * Values that fill a whole slot are stored without loading the slot first. Packed values
+ * load the slot and store it back; to update several values in one slot with a single
+ * SLOAD/SSTORE pair use PackedSlot.
+ *
+ * Supported value types: bool, (u)int8..64_t, Address, Bytes32, and any type with a
+ * stylus::storage_traits specialization (see u256.hpp).
+ * No C++ standard library headers are used, so it builds with --no-standard-libraries.
+ *
+ * requires: stylus/types.hpp, bebi.h(string.h), storage.h, hostio.h
+ * c-file: storage.c
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <bebi.h>
+#include <storage.h>
+#include <stylus/types.hpp>
+
+namespace stylus {
+
+/**
+ * a 32-byte big-endian storage slot
+ */
+struct Slot {
+    uint8_t bytes[32];
+
+    /**
+     * slot number n, as in solc's storageLayout
+     */
+    static constexpr Slot of(uint64_t n) {
+        Slot slot{};
+        for (int i = 0; i < 8; i++) {
+            slot.bytes[31 - i] = (uint8_t)(n >> (8 * i));
+        }
+        return slot;
+    }
+
+    /**
+     * slot + n (slots of struct fields and static array elements)
+     */
+    constexpr Slot plus(uint64_t n) const {
+        Slot slot = *this;
+        for (int i = 31; i >= 0 && n != 0; i--) {
+            uint64_t sum = (uint64_t)slot.bytes[i] + (n & 0xff);
+            slot.bytes[i] = (uint8_t)sum;
+            n = (n >> 8) + (sum >> 8);
+        }
+        return slot;
+    }
+};
+
+/**
+ * how a value type is packed in a slot
+ * size: bytes taken in the slot
+ * load/store: read or write the value whose first (most significant) byte is at pos
+ */
+template <typename T, typename Enable = void>
+struct storage_traits;
+
+namespace detail {
+
+template <bool B, typename T = void>
+struct enable_if {};
+
+template <typename T>
+struct enable_if<true, T> {
+    typedef T type;
+};
+
+template <typename T>
+struct is_integer {
+    static constexpr bool value = false;
+};
+
+#define STYLUS_INTEGER(type) \
+    template <>              \
+    struct is_integer<type> { static constexpr bool value = true; };
+STYLUS_INTEGER(uint8_t)
+STYLUS_INTEGER(uint16_t)
+STYLUS_INTEGER(uint32_t)
+STYLUS_INTEGER(uint64_t)
+STYLUS_INTEGER(int8_t)
+STYLUS_INTEGER(int16_t)
+STYLUS_INTEGER(int32_t)
+STYLUS_INTEGER(int64_t)
+#undef STYLUS_INTEGER
+
+template <typename T>
+constexpr bool is_signed() {
+    return (T)-1 < (T)0;
+}
+
+}  // namespace detail
+
+template <typename T>
+struct storage_traits<T, typename detail::enable_if<detail::is_integer<T>::value>::type> {
+    static constexpr size_t size = sizeof(T);
+
+    static T load(const uint8_t *src, size_t pos) {
+        if (size == 1) {
+            return (T)bebi_get_u8(src, pos);
+        } else if (size == 2) {
+            return (T)bebi_get_u16(src, pos);
+        } else if (size == 4) {
+            return (T)bebi_get_u32(src, pos);
+        }
+        return (T)bebi_get_u64(src, pos);
+    }
+
+    static void store(uint8_t *dst, size_t pos, T val) {
+        if (size == 1) {
+            bebi_set_u8(dst, pos, (uint8_t)val);
+        } else if (size == 2) {
+            bebi_set_u16(dst, pos, (uint16_t)val);
+        } else if (size == 4) {
+            bebi_set_u32(dst, pos, (uint32_t)val);
+        } else {
+            bebi_set_u64(dst, pos, (uint64_t)val);
+        }
+    }
+
+    // map keys are padded to 32 bytes, signed values are sign-extended
+    static void key(const T &val, uint8_t *out) {
+        memset(out, (detail::is_signed<T>() && val < 0) ? 0xff : 0, 32 - size);
+        store(out, 32 - size, val);
+    }
+};
+
+template <>
+struct storage_traits<bool> {
+    static constexpr size_t size = 1;
+
+    static bool load(const uint8_t *src, size_t pos) {
+        return src[pos] != 0;
+    }
+
+    static void store(uint8_t *dst, size_t pos, bool val) {
+        dst[pos] = val ? 1 : 0;
+    }
+
+    static void key(const bool &val, uint8_t *out) {
+        memset(out, 0, 32);
+        out[31] = val ? 1 : 0;
+    }
+};
+
+template <>
+struct storage_traits<Address> {
+    static constexpr size_t size = 20;
+
+    static Address load(const uint8_t *src, size_t pos) {
+        Address res;
+        memcpy(res.bytes, src + pos, 20);
+        return res;
+    }
+
+    static void store(uint8_t *dst, size_t pos, const Address &val) {
+        memcpy(dst + pos, val.bytes, 20);
+    }
+
+    static void key(const Address &val, uint8_t *out) {
+        memset(out, 0, 12);
+        memcpy(out + 12, val.bytes, 20);
+    }
+};
+
+template <>
+struct storage_traits<Bytes32> {
+    static constexpr size_t size = 32;
+
+    static Bytes32 load(const uint8_t *src, size_t pos) {
+        Bytes32 res;
+        memcpy(res.bytes, src + pos, 32);
+        return res;
+    }
+
+    static void store(uint8_t *dst, size_t pos, const Bytes32 &val) {
+        memcpy(dst + pos, val.bytes, 32);
+    }
+
+    static void key(const Bytes32 &val, uint8_t *out) {
+        memcpy(out, val.bytes, 32);
+    }
+};
+
+/**
+ * a value at a slot known at runtime, e.g. an entry of a map or array
+ * pos is the byte position of the value's first byte in the slot (32 - offset - size)
+ */
+template <typename T>
+class StorageRef {
+public:
+    typedef storage_traits<T> traits;
+
+    constexpr StorageRef(const Slot &slot, size_t pos = 32 - traits::size) : slot_(slot), pos_(pos) {}
+
+    T get() const {
+        uint8_t buf[32];
+        storage_load(nullptr, slot_.bytes, buf);
+        return traits::load(buf, pos_);
+    }
+
+    void set(const T &val) const {
+        uint8_t buf[32];
+        if (traits::size < 32) {
+            storage_load(nullptr, slot_.bytes, buf);
+        }
+        traits::store(buf, pos_, val);
+        storage_store(nullptr, slot_.bytes, buf);
+    }
+
+    const Slot &slot() const {
+        return slot_;
+    }
+
+    size_t pos() const {
+        return pos_;
+    }
+
+private:
+    Slot slot_;
+    size_t pos_;
+};
+
+/**
+ * a state variable at a fixed slot and solidity offset
+ */
+template <typename T, uint64_t SlotN, size_t Offset = 0>
+class StorageValue {
+public:
+    typedef T value_type;
+    typedef storage_traits<T> traits;
+    static_assert(Offset + traits::size <= 32, "value does not fit in its slot");
+
+    static constexpr uint64_t slot_number = SlotN;
+    static constexpr Slot slot = Slot::of(SlotN);
+    // position of the value's first byte in the big-endian slot
+    static constexpr size_t pos = 32 - Offset - traits::size;
+
+    static T get() {
+        return StorageRef<T>(slot, pos).get();
+    }
+
+    static void set(const T &val) {
+        StorageRef<T>(slot, pos).set(val);
+    }
+};
+
+/**
+ * a slot loaded once, to read and update several packed StorageValues with a single
+ * SLOAD and a single SSTORE:
+ *
+ *     PackedSlot<1> shorts;
+ *     uint64_t current = shorts.get<decltype(minters_current)>();
+ *     shorts.set<decltype(minters_current)>(current + 1);
+ *     shorts.store();
+ */
+template <uint64_t SlotN>
+class PackedSlot {
+public:
+    static constexpr Slot slot = Slot::of(SlotN);
+
+    PackedSlot() {
+        storage_load(nullptr, slot.bytes, buf_);
+    }
+
+    template <typename Value>
+    typename Value::value_type get() const {
+        static_assert(Value::slot_number == SlotN, "value is not in this slot");
+        return Value::traits::load(buf_, Value::pos);
+    }
+
+    template <typename Value>
+    void set(const typename Value::value_type &val) {
+        static_assert(Value::slot_number == SlotN, "value is not in this slot");
+        Value::traits::store(buf_, Value::pos, val);
+    }
+
+    void store() const {
+        storage_store(nullptr, slot.bytes, buf_);
+    }
+
+private:
+    uint8_t buf_[32];
+};
+
+template <typename K, typename V>
+class StorageMap;
+
+template <typename T>
+class StorageArray;
+
+namespace detail {
+
+// what an entry of a map or array at a runtime slot is accessed through:
+// StorageRef<T> for values, the container itself for nested maps and arrays
+template <typename T>
+struct entry {
+    typedef StorageRef<T> type;
+    static type at(const Slot &slot) {
+        return type(slot);
+    }
+};
+
+template <typename K, typename V>
+struct entry<StorageMap<K, V>> {
+    typedef StorageMap<K, V> type;
+    static type at(const Slot &slot) {
+        return type(slot);
+    }
+};
+
+template <typename T>
+struct entry<StorageArray<T>> {
+    typedef StorageArray<T> type;
+    static type at(const Slot &slot) {
+        return type(slot);
+    }
+};
+
+}  // namespace detail
+
+/**
+ * mapping(K => V). V may be another StorageMap or a StorageArray.
+ * Each lookup costs one keccak (map_slot).
+ */
+template <typename K, typename V>
+class StorageMap {
+public:
+    typedef typename detail::entry<V>::type entry_type;
+
+    constexpr explicit StorageMap(uint64_t slot) : slot_(Slot::of(slot)) {}
+    constexpr explicit StorageMap(const Slot &slot) : slot_(slot) {}
+
+    entry_type operator[](const K &key) const {
+        uint8_t padded[32];
+        Slot slot;
+        storage_traits<K>::key(key, padded);
+        map_slot(slot_.bytes, padded, 32, slot.bytes);
+        return detail::entry<V>::at(slot);
+    }
+
+private:
+    Slot slot_;
+};
+
+/**
+ * T[] (dynamic array). The length is at the array's slot, elements start at keccak(slot).
+ * Elements of 16 bytes or less are packed, as solidity does.
+ *
+ * Every operator[], push and pop hashes the base slot once. To access several elements,
+ * elements() hashes it once for all of them.
+ */
+template <typename T>
+class StorageArray {
+public:
+    typedef storage_traits<T> traits;
+    static constexpr size_t per_slot = 32 / traits::size;
+
+    /**
+     * the elements of an array, with the base slot already computed
+     */
+    class Elements {
+    public:
+        explicit Elements(const Slot &base) : base_(base) {}
+
+        /**
+         * element at index, not bounds checked
+         */
+        StorageRef<T> operator[](uint64_t index) const {
+            size_t pos = 32 - (size_t)(index % per_slot + 1) * traits::size;
+            return StorageRef<T>(base_.plus(index / per_slot), pos);
+        }
+
+    private:
+        Slot base_;
+    };
+
+    constexpr explicit StorageArray(uint64_t slot) : slot_(Slot::of(slot)) {}
+    constexpr explicit StorageArray(const Slot &slot) : slot_(slot) {}
+
+    uint64_t size() const {
+        uint8_t buf[32];
+        storage_load(nullptr, slot_.bytes, buf);
+        return bebi32_get_u64(buf);
+    }
+
+    void set_size(uint64_t len) const {
+        uint8_t buf[32];
+        bebi32_set_u64(buf, len);
+        storage_store(nullptr, slot_.bytes, buf);
+    }
+
+    Elements elements() const {
+        Slot base;
+        dynamic_array_base_slot(slot_.bytes, base.bytes);
+        return Elements(base);
+    }
+
+    /**
+     * element at index, not bounds checked
+     */
+    StorageRef<T> operator[](uint64_t index) const {
+        return elements()[index];
+    }
+
+    void push(const T &val) const {
+        uint64_t len = size();
+        elements()[len].set(val);
+        set_size(len + 1);
+    }
+
+    /**
+     * removes the last element, zeroing it as solidity does. returns false if empty
+     */
+    bool pop() const {
+        uint64_t len = size();
+        if (len == 0) {
+            return false;
+        }
+        elements()[len - 1].set(T{});
+        set_size(len - 1);
+        return true;
+    }
+
+private:
+    Slot slot_;
+};
+
+}  // namespace stylus
+
+#endif  // __STYLUS_STORAGE_HPP
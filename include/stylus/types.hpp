@@ -0,0 +1,31 @@
+#ifndef __STYLUS_TYPES_HPP
+#define __STYLUS_TYPES_HPP
+
+/**
+ * stylus/types.hpp defines the fixed-size byte values shared by the C++ headers
+ *
+ * requires: -
+ * c-file: -
+ */
+
+#include <stdint.h>
+
+namespace stylus {
+
+/**
+ * a 20-byte address
+ */
+struct Address {
+    uint8_t bytes[20];
+};
+
+/**
+ * 32 bytes, e.g. a hash or an abi word
+ */
+struct Bytes32 {
+    uint8_t bytes[32];
+};
+
+}  // namespace stylus
+
+#endif  // __STYLUS_TYPES_HPP
@@ -0,0 +1,658 @@
+#ifndef __STYLUS_U256_HPP
+#define __STYLUS_U256_HPP
+
+/**
+ * stylus/u256.hpp is an unsigned 256-bit integer for C++ contracts (C++17 or newer, header only)
+ *
+ * U256 keeps four native 64-bit limbs, so arithmetic does not go through big-endian buffers.
+ * bebi32 values (calldata, storage, return data) are converted in a single pass:
+ * from_be reads straight from the source bytes and to_be writes straight into the
+ * destination, so no temporary buffer is needed. As a storage_traits type, U256 is
+ * loaded and stored by StorageValue/StorageMap/StorageArray (stylus/storage.hpp).
+ *
+ * Everything is constexpr, so constants fold at compile time:
+ *     constexpr U256 one_token = U256::pow(10, 18);
+ *     constexpr U256 cap = 1000000000000000000000000_u256;
+ * The _u256 literal is declared in namespace stylus (using stylus::operator""_u256).
+ * A literal that does not fit 256 bits fails to compile.
+ *
+ * Operators wrap around on overflow, and division by zero gives zero, as in EVM opcodes.
+ * add_overflow, sub_overflow and mul_overflow report overflow, and checked_add,
+ * checked_sub, checked_mul and checked_div revert on it (solidity's default behavior).
+ *
+ * Fused operations compute the result without intermediate overflow or extra temporaries:
+ *  * mul_div(a, b, c): a * b / c with a 512-bit product
+ *  * mul_mod, add_mod: as the EVM's MULMOD and ADDMOD
+ *  * add_lt(a, b, c): a + b < c, exact even when a + b overflows
+ *
+ * No 128-bit integer types are used, so no compiler runtime is needed on wasm32.
+ *
+ * requires: stylus/storage.hpp, stylus_types.h (revert)
+ * c-file: -
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stylus_types.h>
+#include <stylus/storage.hpp>
+
+namespace stylus {
+
+class U256 {
+public:
+    // limbs[0] is the least significant
+    uint64_t limbs[4];
+
+    constexpr U256() : limbs{0, 0, 0, 0} {}
+    constexpr U256(uint64_t val) : limbs{val, 0, 0, 0} {}
+
+    /**
+     * from limbs, most significant first
+     */
+    static constexpr U256 from_limbs(uint64_t l3, uint64_t l2, uint64_t l1, uint64_t l0) {
+        U256 res;
+        res.limbs[0] = l0;
+        res.limbs[1] = l1;
+        res.limbs[2] = l2;
+        res.limbs[3] = l3;
+        return res;
+    }
+
+    static constexpr U256 max() {
+        return from_limbs(~0ULL, ~0ULL, ~0ULL, ~0ULL);
+    }
+
+    /**
+     * from 32 big-endian bytes, e.g. a bebi32 or an abi word in calldata
+     */
+    static constexpr U256 from_be(const uint8_t *src) {
+        U256 res;
+        for (int i = 0; i < 4; i++) {
+            uint64_t limb = 0;
+            for (int j = 0; j < 8; j++) {
+                limb = (limb << 8) | src[8 * (3 - i) + j];
+            }
+            res.limbs[i] = limb;
+        }
+        return res;
+    }
+
+    /**
+     * to 32 big-endian bytes
+     */
+    constexpr void to_be(uint8_t *dst) const {
+        for (int i = 0; i < 4; i++) {
+            uint64_t limb = limbs[i];
+            for (int j = 7; j >= 0; j--) {
+                dst[8 * (3 - i) + j] = (uint8_t)limb;
+                limb >>= 8;
+            }
+        }
+    }
+
+    constexpr bool is_zero() const {
+        return (limbs[0] | limbs[1] | limbs[2] | limbs[3]) == 0;
+    }
+
+    constexpr bool fits_u64() const {
+        return (limbs[1] | limbs[2] | limbs[3]) == 0;
+    }
+
+    constexpr uint64_t low_u64() const {
+        return limbs[0];
+    }
+
+    // comparison
+
+    friend constexpr bool operator==(const U256 &a, const U256 &b) {
+        return a.limbs[0] == b.limbs[0] && a.limbs[1] == b.limbs[1] && a.limbs[2] == b.limbs[2] &&
+               a.limbs[3] == b.limbs[3];
+    }
+
+    friend constexpr bool operator!=(const U256 &a, const U256 &b) {
+        return !(a == b);
+    }
+
+    friend constexpr bool operator<(const U256 &a, const U256 &b) {
+        for (int i = 3; i >= 0; i--) {
+            if (a.limbs[i] != b.limbs[i]) {
+                return a.limbs[i] < b.limbs[i];
+            }
+        }
+        return false;
+    }
+
+    friend constexpr bool operator>(const U256 &a, const U256 &b) {
+        return b < a;
+    }
+
+    friend constexpr bool operator<=(const U256 &a, const U256 &b) {
+        return !(b < a);
+    }
+
+    friend constexpr bool operator>=(const U256 &a, const U256 &b) {
+        return !(a < b);
+    }
+
+    // overflow-reporting arithmetic: return true if the result wrapped around
+
+    static constexpr bool add_overflow(const U256 &a, const U256 &b, U256 &out) {
+        uint64_t carry = 0;
+        for (int i = 0; i < 4; i++) {
+            uint64_t sum = a.limbs[i] + b.limbs[i];
+            uint64_t c = sum < a.limbs[i];
+            out.limbs[i] = sum + carry;
+            carry = c | (out.limbs[i] < sum);
+        }
+        return carry != 0;
+    }
+
+    static constexpr bool sub_overflow(const U256 &a, const U256 &b, U256 &out) {
+        uint64_t borrow = 0;
+        for (int i = 0; i < 4; i++) {
+            uint64_t diff = a.limbs[i] - b.limbs[i];
+            uint64_t c = a.limbs[i] < b.limbs[i];
+            out.limbs[i] = diff - borrow;
+            borrow = c | (diff < borrow);
+        }
+        return borrow != 0;
+    }
+
+    static constexpr bool mul_overflow(const U256 &a, const U256 &b, U256 &out) {
+        uint64_t wide[8] = {0};
+        mul_wide(a, b, wide);
+        for (int i = 0; i < 4; i++) {
+            out.limbs[i] = wide[i];
+        }
+        return (wide[4] | wide[5] | wide[6] | wide[7]) != 0;
+    }
+
+    // wrapping arithmetic
+
+    friend constexpr U256 operator+(const U256 &a, const U256 &b) {
+        U256 res;
+        add_overflow(a, b, res);
+        return res;
+    }
+
+    friend constexpr U256 operator-(const U256 &a, const U256 &b) {
+        U256 res;
+        sub_overflow(a, b, res);
+        return res;
+    }
+
+    friend constexpr U256 operator*(const U256 &a, const U256 &b) {
+        U256 res;
+        for (int i = 0; i < 4; i++) {
+            uint64_t carry = 0;
+            for (int j = 0; i + j < 4; j++) {
+                uint64_t hi = 0;
+                uint64_t lo = 0;
+                mul64(a.limbs[i], b.limbs[j], hi, lo);
+                uint64_t t = res.limbs[i + j] + lo;
+                hi += t < lo;
+                res.limbs[i + j] = t + carry;
+                hi += res.limbs[i + j] < t;
+                carry = hi;
+            }
+        }
+        return res;
+    }
+
+    friend constexpr U256 operator/(const U256 &a, const U256 &b) {
+        U256 quot;
+        U256 rem;
+        divmod(a, b, quot, rem);
+        return quot;
+    }
+
+    friend constexpr U256 operator%(const U256 &a, const U256 &b) {
+        U256 quot;
+        U256 rem;
+        divmod(a, b, quot, rem);
+        return rem;
+    }
+
+    /**
+     * quotient and remainder in one division. Both are zero if b is zero.
+     */
+    static constexpr void divmod(const U256 &a, const U256 &b, U256 &quot, U256 &rem) {
+        uint32_t u[8] = {0};
+        uint32_t v[8] = {0};
+        uint32_t q[8] = {0};
+        uint32_t r[8] = {0};
+        to_digits(a.limbs, 4, u);
+        to_digits(b.limbs, 4, v);
+        int n = significant(v, 8);
+        if (n == 0) {
+            quot = U256();
+            rem = U256();
+            return;
+        }
+        divmod_digits(u, significant(u, 8), v, n, q, r);
+        from_digits(q, 4, quot.limbs);
+        from_digits(r, 4, rem.limbs);
+    }
+
+    // bitwise
+
+    friend constexpr U256 operator&(const U256 &a, const U256 &b) {
+        return from_limbs(a.limbs[3] & b.limbs[3], a.limbs[2] & b.limbs[2], a.limbs[1] & b.limbs[1],
+                          a.limbs[0] & b.limbs[0]);
+    }
+
+    friend constexpr U256 operator|(const U256 &a, const U256 &b) {
+        return from_limbs(a.limbs[3] | b.limbs[3], a.limbs[2] | b.limbs[2], a.limbs[1] | b.limbs[1],
+                          a.limbs[0] | b.limbs[0]);
+    }
+
+    friend constexpr U256 operator^(const U256 &a, const U256 &b) {
+        return from_limbs(a.limbs[3] ^ b.limbs[3], a.limbs[2] ^ b.limbs[2], a.limbs[1] ^ b.limbs[1],
+                          a.limbs[0] ^ b.limbs[0]);
+    }
+
+    friend constexpr U256 operator~(const U256 &a) {
+        return from_limbs(~a.limbs[3], ~a.limbs[2], ~a.limbs[1], ~a.limbs[0]);
+    }
+
+    friend constexpr U256 operator<<(const U256 &a, unsigned shift) {
+        U256 res;
+        if (shift >= 256) {
+            return res;
+        }
+        unsigned words = shift / 64;
+        unsigned bits = shift % 64;
+        for (int i = 3; i >= (int)words; i--) {
+            res.limbs[i] = a.limbs[i - words] << bits;
+            if (bits != 0 && i > (int)words) {
+                res.limbs[i] |= a.limbs[i - words - 1] >> (64 - bits);
+            }
+        }
+        return res;
+    }
+
+    friend constexpr U256 operator>>(const U256 &a, unsigned shift) {
+        U256 res;
+        if (shift >= 256) {
+            return res;
+        }
+        unsigned words = shift / 64;
+        unsigned bits = shift % 64;
+        for (int i = 0; i + (int)words < 4; i++) {
+            res.limbs[i] = a.limbs[i + words] >> bits;
+            if (bits != 0 && i + (int)words + 1 < 4) {
+                res.limbs[i] |= a.limbs[i + words + 1] << (64 - bits);
+            }
+        }
+        return res;
+    }
+
+    constexpr U256 &operator+=(const U256 &b) {
+        return *this = *this + b;
+    }
+
+    constexpr U256 &operator-=(const U256 &b) {
+        return *this = *this - b;
+    }
+
+    constexpr U256 &operator*=(const U256 &b) {
+        return *this = *this * b;
+    }
+
+    constexpr U256 &operator/=(const U256 &b) {
+        return *this = *this / b;
+    }
+
+    constexpr U256 &operator%=(const U256 &b) {
+        return *this = *this % b;
+    }
+
+    constexpr U256 &operator&=(const U256 &b) {
+        return *this = *this & b;
+    }
+
+    constexpr U256 &operator|=(const U256 &b) {
+        return *this = *this | b;
+    }
+
+    constexpr U256 &operator^=(const U256 &b) {
+        return *this = *this ^ b;
+    }
+
+    constexpr U256 &operator<<=(unsigned shift) {
+        return *this = *this << shift;
+    }
+
+    constexpr U256 &operator>>=(unsigned shift) {
+        return *this = *this >> shift;
+    }
+
+    /**
+     * base ** exp, wrapping
+     */
+    static constexpr U256 pow(U256 base, uint64_t exp) {
+        U256 res(1);
+        while (exp != 0) {
+            if (exp & 1) {
+                res *= base;
+            }
+            base *= base;
+            exp >>= 1;
+        }
+        return res;
+    }
+
+    // checked arithmetic: revert on overflow or division by zero
+
+    static constexpr U256 checked_add(const U256 &a, const U256 &b) {
+        U256 res;
+        if (add_overflow(a, b, res)) {
+            revert();
+        }
+        return res;
+    }
+
+    static constexpr U256 checked_sub(const U256 &a, const U256 &b) {
+        U256 res;
+        if (sub_overflow(a, b, res)) {
+            revert();
+        }
+        return res;
+    }
+
+    static constexpr U256 checked_mul(const U256 &a, const U256 &b) {
+        U256 res;
+        if (mul_overflow(a, b, res)) {
+            revert();
+        }
+        return res;
+    }
+
+    static constexpr U256 checked_div(const U256 &a, const U256 &b) {
+        if (b.is_zero()) {
+            revert();
+        }
+        return a / b;
+    }
+
+    // fused operations
+
+    /**
+     * out = a * b / c, rounded down, with the product kept at 512 bits
+     * returns false if c is zero or the result does not fit 256 bits
+     */
+    static constexpr bool mul_div(const U256 &a, const U256 &b, const U256 &c, U256 &out) {
+        uint64_t wide[8] = {0};
+        uint32_t q[16] = {0};
+        uint32_t r[8] = {0};
+        if (!wide_divmod(a, b, c, wide, q, r)) {
+            return false;
+        }
+        for (int i = 8; i < 16; i++) {
+            if (q[i] != 0) {
+                return false;
+            }
+        }
+        from_digits(q, 4, out.limbs);
+        return true;
+    }
+
+    /**
+     * a * b % m, with the product kept at 512 bits. Zero if m is zero, as MULMOD.
+     */
+    static constexpr U256 mul_mod(const U256 &a, const U256 &b, const U256 &m) {
+        uint64_t wide[8] = {0};
+        uint32_t q[16] = {0};
+        uint32_t r[8] = {0};
+        U256 res;
+        if (wide_divmod(a, b, m, wide, q, r)) {
+            from_digits(r, 4, res.limbs);
+        }
+        return res;
+    }
+
+    /**
+     * (a + b) % m, with the sum kept at 257 bits. Zero if m is zero, as ADDMOD.
+     */
+    static constexpr U256 add_mod(const U256 &a, const U256 &b, const U256 &m) {
+        if (m.is_zero()) {
+            return U256();
+        }
+        U256 sum;
+        if (!add_overflow(a, b, sum)) {
+            return sum % m;
+        }
+        // sum + 2**256 == sum + (2**256 - m) + m
+        U256 a_mod = a % m;
+        U256 b_mod = b % m;
+        U256 res;
+        if (add_overflow(a_mod, b_mod, res) || res >= m) {
+            res -= m;
+        }
+        return res;
+    }
+
+    /**
+     * a + b < c, exact even if a + b overflows 256 bits
+     */
+    static constexpr bool add_lt(const U256 &a, const U256 &b, const U256 &c) {
+        U256 sum;
+        if (add_overflow(a, b, sum)) {
+            return false;
+        }
+        return sum < c;
+    }
+
+private:
+    static constexpr void mul64(uint64_t a, uint64_t b, uint64_t &hi, uint64_t &lo) {
+        uint64_t a0 = a & 0xffffffff;
+        uint64_t a1 = a >> 32;
+        uint64_t b0 = b & 0xffffffff;
+        uint64_t b1 = b >> 32;
+        uint64_t p00 = a0 * b0;
+        uint64_t p01 = a0 * b1;
+        uint64_t p10 = a1 * b0;
+        uint64_t p11 = a1 * b1;
+        uint64_t mid = (p00 >> 32) + (p01 & 0xffffffff) + (p10 & 0xffffffff);
+        lo = (mid << 32) | (p00 & 0xffffffff);
+        hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+    }
+
+    // full 512-bit product, least significant limb first
+    static constexpr void mul_wide(const U256 &a, const U256 &b, uint64_t wide[8]) {
+        for (int i = 0; i < 4; i++) {
+            uint64_t carry = 0;
+            for (int j = 0; j < 4; j++) {
+                uint64_t hi = 0;
+                uint64_t lo = 0;
+                mul64(a.limbs[i], b.limbs[j], hi, lo);
+                uint64_t t = wide[i + j] + lo;
+                hi += t < lo;
+                wide[i + j] = t + carry;
+                hi += wide[i + j] < t;
+                carry = hi;
+            }
+            wide[i + 4] = carry;
+        }
+    }
+
+    // a * b divided by c: q gets 16 digits, r 8. returns false if c is zero
+    static constexpr bool wide_divmod(const U256 &a, const U256 &b, const U256 &c, uint64_t wide[8],
+                                      uint32_t q[16], uint32_t r[8]) {
+        uint32_t u[16] = {0};
+        uint32_t v[8] = {0};
+        to_digits(c.limbs, 4, v);
+        int n = significant(v, 8);
+        if (n == 0) {
+            return false;
+        }
+        mul_wide(a, b, wide);
+        to_digits(wide, 8, u);
+        divmod_digits(u, significant(u, 16), v, n, q, r);
+        return true;
+    }
+
+    static constexpr void to_digits(const uint64_t *limbs, int count, uint32_t *digits) {
+        for (int i = 0; i < count; i++) {
+            digits[2 * i] = (uint32_t)limbs[i];
+            digits[2 * i + 1] = (uint32_t)(limbs[i] >> 32);
+        }
+    }
+
+    static constexpr void from_digits(const uint32_t *digits, int count, uint64_t *limbs) {
+        for (int i = 0; i < count; i++) {
+            limbs[i] = (uint64_t)digits[2 * i] | ((uint64_t)digits[2 * i + 1] << 32);
+        }
+    }
+
+    static constexpr int significant(const uint32_t *digits, int count) {
+        while (count > 0 && digits[count - 1] == 0) {
+            count--;
+        }
+        return count;
+    }
+
+    static constexpr int leading_zeros(uint32_t x) {
+        int n = 0;
+        while ((x & 0x80000000u) == 0) {
+            x <<= 1;
+            n++;
+        }
+        return n;
+    }
+
+    /**
+     * long division of m-digit u by n-digit v (Knuth's algorithm D), 32-bit digits.
+     * v[n-1] != 0. q gets m-n+1 digits, r gets n digits. Other digits are left as they are.
+     */
+    static constexpr void divmod_digits(const uint32_t *u, int m, const uint32_t *v, int n, uint32_t *q,
+                                        uint32_t *r) {
+        const uint64_t base = 1ULL << 32;
+        if (m < n) {
+            for (int i = 0; i < n; i++) {
+                r[i] = i < m ? u[i] : 0;
+            }
+            return;
+        }
+        if (n == 1) {
+            uint64_t rem = 0;
+            for (int j = m - 1; j >= 0; j--) {
+                uint64_t t = rem * base + u[j];
+                q[j] = (uint32_t)(t / v[0]);
+                rem = t - (uint64_t)q[j] * v[0];
+            }
+            r[0] = (uint32_t)rem;
+            return;
+        }
+        // normalize so the top digit of v has its high bit set
+        int s = leading_zeros(v[n - 1]);
+        uint32_t vn[8] = {0};
+        uint32_t un[17] = {0};
+        for (int i = n - 1; i > 0; i--) {
+            vn[i] = (uint32_t)(((uint64_t)v[i] << s) | ((uint64_t)v[i - 1] >> (32 - s)));
+        }
+        vn[0] = v[0] << s;
+        un[m] = (uint32_t)((uint64_t)u[m - 1] >> (32 - s));
+        for (int i = m - 1; i > 0; i--) {
+            un[i] = (uint32_t)(((uint64_t)u[i] << s) | ((uint64_t)u[i - 1] >> (32 - s)));
+        }
+        un[0] = u[0] << s;
+
+        for (int j = m - n; j >= 0; j--) {
+            // estimate the quotient digit, then correct it
+            uint64_t top = ((uint64_t)un[j + n] << 32) | un[j + n - 1];
+            uint64_t qhat = top / vn[n - 1];
+            uint64_t rhat = top - qhat * vn[n - 1];
+            while (qhat >= base || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2])) {
+                qhat--;
+                rhat += vn[n - 1];
+                if (rhat >= base) {
+                    break;
+                }
+            }
+            // multiply and subtract
+            int64_t borrow = 0;
+            int64_t t = 0;
+            for (int i = 0; i < n; i++) {
+                uint64_t p = qhat * vn[i];
+                t = (int64_t)un[i + j] - borrow - (int64_t)(p & 0xffffffff);
+                un[i + j] = (uint32_t)t;
+                borrow = (int64_t)(p >> 32) - (t >> 32);
+            }
+            t = (int64_t)un[j + n] - borrow;
+            un[j + n] = (uint32_t)t;
+            q[j] = (uint32_t)qhat;
+            // subtracted too much: add back
+            if (t < 0) {
+                q[j]--;
+                uint64_t carry = 0;
+                for (int i = 0; i < n; i++) {
+                    uint64_t sum = (uint64_t)un[i + j] + vn[i] + carry;
+                    un[i + j] = (uint32_t)sum;
+                    carry = sum >> 32;
+                }
+                un[j + n] += (uint32_t)carry;
+            }
+        }
+        for (int i = 0; i < n; i++) {
+            r[i] = (uint32_t)(((uint64_t)un[i] >> s) | ((uint64_t)un[i + 1] << (32 - s)));
+        }
+    }
+};
+
+// not defined: using it in a constant expression makes an oversized literal a compile error
+void u256_literal_out_of_range();
+
+/**
+ * decimal or 0x-prefixed hex literal, e.g. 1000000000000000000_u256
+ */
+constexpr U256 operator""_u256(const char *literal) {
+    U256 res;
+    bool overflow = false;
+    unsigned radix = 10;
+    if (literal[0] == '0' && (literal[1] == 'x' || literal[1] == 'X')) {
+        radix = 16;
+        literal += 2;
+    }
+    for (; *literal != 0; literal++) {
+        char c = *literal;
+        unsigned digit = 0;
+        if (c == '\'') {
+            continue;
+        } else if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            digit = c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            digit = c - 'A' + 10;
+        }
+        U256 shifted;
+        overflow |= U256::mul_overflow(res, U256(radix), shifted);
+        overflow |= U256::add_overflow(shifted, U256(digit), res);
+    }
+    if (overflow) {
+        u256_literal_out_of_range();
+    }
+    return res;
+}
+
+template <>
+struct storage_traits<U256> {
+    static constexpr size_t size = 32;
+
+    static U256 load(const uint8_t *src, size_t pos) {
+        return U256::from_be(src + pos);
+    }
+
+    static void store(uint8_t *dst, size_t pos, const U256 &val) {
+        val.to_be(dst + pos);
+    }
+
+    static void key(const U256 &val, uint8_t *out) {
+        val.to_be(out);
+    }
+};
+
+}  // namespace stylus
+
+#endif  // __STYLUS_U256_HPP
@@ -16,7 +16,11 @@
 extern "C" {
 #endif
 
+#ifdef __wasm__
 #define CONSOLE(name) extern __attribute__((import_module("console"),  import_name(#name)))
+#else
+#define CONSOLE(name) extern
+#endif
 
 /**
  * Prints a 32-bit floating point number to the console, Only available in debug mode with
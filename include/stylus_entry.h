@@ -8,6 +8,9 @@
  * This defines the entrypoint to a smart contract.
  * Only one file per wasm is expected to have an entrypoint
  *
+ * With STYLUS_TRACE defined, the entrypoint also prints a hostio trace, see stylus_trace.h
+ * With STYLUS_PROFILE defined, it prints the ink used by profiled regions, see stylus_profile.h
+ *
  * requires: stylus_types.h
  * c-file: -
  */
@@ -17,25 +20,36 @@
 
 #include "hostio.h"
 #include "stylus_types.h"
+#include "stylus_profile.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#ifdef __wasm__
+#define STYLUS_EXPORT(name) __attribute__((export_name(#name)))
+#else
+#define STYLUS_EXPORT(name)
+#endif
+
 #define ENTRYPOINT(user_main)                                           \
     /* Force the compiler to import these symbols                    */ \
     /* Note: calling these functions will unproductively consume gas */ \
-    __attribute__((export_name("mark_used")))                           \
+    STYLUS_EXPORT(mark_used)                                            \
     void mark_used() {                                                  \
         memory_grow(0);                                                 \
     }                                                                   \
                                                                         \
-    __attribute__((export_name("user_entrypoint")))                     \
+    STYLUS_EXPORT(user_entrypoint)                                      \
     int user_entrypoint(size_t args_len) {                              \
+        STYLUS_TRACE_RESET();                                           \
+        STYLUS_PROFILE_RESET();                                         \
         uint8_t args[args_len];                                         \
         read_args(args);                                                \
         const ArbResult result = user_main(args, args_len);             \
         write_result(result.output, result.output_len);                 \
+        STYLUS_TRACE_DUMP();                                            \
+        STYLUS_PROFILE_DUMP();                                          \
         return result.status;                                           \
     }
 
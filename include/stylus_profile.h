@@ -0,0 +1,81 @@
+// Copyright 2022-2023, Offchain Labs, Inc.
+// For licensing, see https://github.com/stylus-sdk-c/blob/stylus/licenses/COPYRIGHT.md
+
+#ifndef __STYLUS_PROFILE_H
+#define __STYLUS_PROFILE_H
+
+/**
+ * Ink profiler for regions of contract code, enabled by compiling with -DSTYLUS_PROFILE.
+ *
+ *     PROFILE_BEGIN(load_balance);
+ *     ...
+ *     PROFILE_END(load_balance);
+ *
+ * Each region totals the ink used between BEGIN and END (measured with evm_ink_left,
+ * less the cost of measuring) and the number of times it ran.
+ * BEGIN and END must be in the same block. A run that leaves the block without reaching
+ * END is not recorded. Nested regions include the measuring cost of the inner ones.
+ * Regions are kept per call site: the same name in two functions shows up twice.
+ *
+ * ENTRYPOINT resets the totals on entry and, after write_result, prints each region:
+ * its name with log_txt, then its run count and ink with log_i64 (stylus_debug.h).
+ * At most STYLUS_PROFILE_MAX_REGIONS regions are printed.
+ *
+ * Without STYLUS_PROFILE, all macros expand to nothing.
+ *
+ * requires: hostio.h, stylus_debug.h
+ * c-file: profile.c
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef STYLUS_PROFILE
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef STYLUS_PROFILE_MAX_REGIONS
+#define STYLUS_PROFILE_MAX_REGIONS 32
+#endif
+
+typedef struct stylus_profile_region {
+    const char *name;
+    uint32_t calls;
+    uint64_t ink;
+    bool registered;
+} stylus_profile_region;
+
+void stylus_profile_reset();
+void stylus_profile_dump();
+
+// used by the macros below
+uint64_t stylus_profile_start();
+void stylus_profile_end(stylus_profile_region *region, uint64_t start);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define PROFILE_BEGIN(name)                                                                 \
+    static stylus_profile_region stylus_profile_region_##name = { #name, 0, 0, false };      \
+    const uint64_t stylus_profile_start_##name = stylus_profile_start()
+
+#define PROFILE_END(name) \
+    stylus_profile_end(&stylus_profile_region_##name, stylus_profile_start_##name)
+
+#define STYLUS_PROFILE_RESET() stylus_profile_reset()
+#define STYLUS_PROFILE_DUMP() stylus_profile_dump()
+
+#else // STYLUS_PROFILE
+
+#define PROFILE_BEGIN(name) ((void)0)
+#define PROFILE_END(name) ((void)0)
+#define STYLUS_PROFILE_RESET() ((void)0)
+#define STYLUS_PROFILE_DUMP() ((void)0)
+
+#endif // STYLUS_PROFILE
+
+#endif // __STYLUS_PROFILE_H
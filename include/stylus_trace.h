@@ -0,0 +1,117 @@
+// Copyright 2022-2023, Offchain Labs, Inc.
+// For licensing, see https://github.com/stylus-sdk-c/blob/stylus/licenses/COPYRIGHT.md
+
+#ifndef __STYLUS_TRACE_H
+#define __STYLUS_TRACE_H
+
+/**
+ * Hostio tracing, enabled by compiling every file (SDK files included) with -DSTYLUS_TRACE.
+ *
+ * Each hostio call site is wrapped with a per-hostio counter. Adding -DSTYLUS_TRACE_INK also
+ * attributes ink to each hostio, using evm_ink_left before and after the call, less the cost
+ * of measuring. This costs two extra hostios per call, so use it to compare, not to price.
+ * A traced hostio evaluated in the arguments of another gets its own ink, which is not
+ * counted again in the enclosing one, up to STYLUS_TRACE_MAX_DEPTH levels of nesting.
+ *
+ * ENTRYPOINT resets the counters on entry, and prints one line per hostio used through
+ * log_txt (stylus_debug.h) after write_result. A call that reverts prints nothing.
+ * log_txt needs a debug-enabled node, the local harness or the simulator.
+ *
+ * Without STYLUS_TRACE, only STYLUS_TRACE_RESET and STYLUS_TRACE_DUMP are defined,
+ * and they expand to nothing.
+ *
+ * requires: hostio.h, stylus_debug.h
+ * c-file: trace.c
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "hostio.h"
+
+#ifdef STYLUS_TRACE
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define STYLUS_TRACE_ID(name) STYLUS_TRACE_##name,
+typedef enum stylus_trace_hostio {
+    STYLUS_HOSTIOS(STYLUS_TRACE_ID)
+    STYLUS_TRACE_HOSTIO_COUNT
+} stylus_trace_hostio;
+#undef STYLUS_TRACE_ID
+
+#ifndef STYLUS_TRACE_MAX_DEPTH
+#define STYLUS_TRACE_MAX_DEPTH 8
+#endif
+
+extern uint32_t stylus_trace_calls[STYLUS_TRACE_HOSTIO_COUNT];
+extern uint64_t stylus_trace_ink[STYLUS_TRACE_HOSTIO_COUNT];
+
+void stylus_trace_reset();
+void stylus_trace_dump();
+
+// used by the wrappers below
+void stylus_trace_begin();
+void stylus_trace_end(stylus_trace_hostio hostio);
+uint64_t stylus_trace_end_value(stylus_trace_hostio hostio, uint64_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define STYLUS_TRACE_RESET() stylus_trace_reset()
+#define STYLUS_TRACE_DUMP() stylus_trace_dump()
+
+#ifdef STYLUS_TRACE_INK
+#define STYLUS_TRACE_VOID(name, call) \
+    (stylus_trace_begin(), (call), stylus_trace_end(STYLUS_TRACE_##name))
+#define STYLUS_TRACE_VALUE(name, type, call) \
+    ((type)stylus_trace_end_value(STYLUS_TRACE_##name, (stylus_trace_begin(), (uint64_t)(call))))
+#else
+#define STYLUS_TRACE_VOID(name, call) (stylus_trace_calls[STYLUS_TRACE_##name]++, (call))
+#define STYLUS_TRACE_VALUE(name, type, call) (stylus_trace_calls[STYLUS_TRACE_##name]++, (call))
+#endif
+
+// files implementing hostios (or the tracer itself) define STYLUS_TRACE_IMPL to opt out
+#ifndef STYLUS_TRACE_IMPL
+#define account_balance(...) STYLUS_TRACE_VOID(account_balance, (account_balance)(__VA_ARGS__))
+#define account_codehash(...) STYLUS_TRACE_VOID(account_codehash, (account_codehash)(__VA_ARGS__))
+#define storage_load_bytes32(...) STYLUS_TRACE_VOID(storage_load_bytes32, (storage_load_bytes32)(__VA_ARGS__))
+#define storage_store_bytes32(...) STYLUS_TRACE_VOID(storage_store_bytes32, (storage_store_bytes32)(__VA_ARGS__))
+#define block_basefee(...) STYLUS_TRACE_VOID(block_basefee, (block_basefee)(__VA_ARGS__))
+#define chainid(...) STYLUS_TRACE_VALUE(chainid, uint64_t, (chainid)(__VA_ARGS__))
+#define block_coinbase(...) STYLUS_TRACE_VOID(block_coinbase, (block_coinbase)(__VA_ARGS__))
+#define block_gas_limit(...) STYLUS_TRACE_VALUE(block_gas_limit, uint64_t, (block_gas_limit)(__VA_ARGS__))
+#define block_number(...) STYLUS_TRACE_VALUE(block_number, uint64_t, (block_number)(__VA_ARGS__))
+#define block_timestamp(...) STYLUS_TRACE_VALUE(block_timestamp, uint64_t, (block_timestamp)(__VA_ARGS__))
+#define call_contract(...) STYLUS_TRACE_VALUE(call_contract, uint8_t, (call_contract)(__VA_ARGS__))
+#define contract_address(...) STYLUS_TRACE_VOID(contract_address, (contract_address)(__VA_ARGS__))
+#define create1(...) STYLUS_TRACE_VOID(create1, (create1)(__VA_ARGS__))
+#define create2(...) STYLUS_TRACE_VOID(create2, (create2)(__VA_ARGS__))
+#define delegate_call_contract(...) STYLUS_TRACE_VALUE(delegate_call_contract, uint8_t, (delegate_call_contract)(__VA_ARGS__))
+#define emit_log(...) STYLUS_TRACE_VOID(emit_log, (emit_log)(__VA_ARGS__))
+#define evm_gas_left(...) STYLUS_TRACE_VALUE(evm_gas_left, uint64_t, (evm_gas_left)(__VA_ARGS__))
+#define evm_ink_left(...) STYLUS_TRACE_VALUE(evm_ink_left, uint64_t, (evm_ink_left)(__VA_ARGS__))
+#define memory_grow(...) STYLUS_TRACE_VOID(memory_grow, (memory_grow)(__VA_ARGS__))
+#define msg_sender(...) STYLUS_TRACE_VOID(msg_sender, (msg_sender)(__VA_ARGS__))
+#define msg_value(...) STYLUS_TRACE_VOID(msg_value, (msg_value)(__VA_ARGS__))
+#define native_keccak256(...) STYLUS_TRACE_VOID(native_keccak256, (native_keccak256)(__VA_ARGS__))
+#define read_args(...) STYLUS_TRACE_VOID(read_args, (read_args)(__VA_ARGS__))
+#define read_return_data(...) STYLUS_TRACE_VALUE(read_return_data, size_t, (read_return_data)(__VA_ARGS__))
+#define write_result(...) STYLUS_TRACE_VOID(write_result, (write_result)(__VA_ARGS__))
+#define return_data_size(...) STYLUS_TRACE_VALUE(return_data_size, size_t, (return_data_size)(__VA_ARGS__))
+#define static_call_contract(...) STYLUS_TRACE_VALUE(static_call_contract, uint8_t, (static_call_contract)(__VA_ARGS__))
+#define tx_gas_price(...) STYLUS_TRACE_VOID(tx_gas_price, (tx_gas_price)(__VA_ARGS__))
+#define tx_ink_price(...) STYLUS_TRACE_VALUE(tx_ink_price, uint64_t, (tx_ink_price)(__VA_ARGS__))
+#define tx_origin(...) STYLUS_TRACE_VOID(tx_origin, (tx_origin)(__VA_ARGS__))
+#endif // STYLUS_TRACE_IMPL
+
+#else // STYLUS_TRACE
+
+#define STYLUS_TRACE_RESET() ((void)0)
+#define STYLUS_TRACE_DUMP() ((void)0)
+
+#endif // STYLUS_TRACE
+
+#endif // __STYLUS_TRACE_H
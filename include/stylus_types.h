@@ -37,9 +37,14 @@ typedef struct ArbResult {
  * This will create a revert by causing a machine error.
  * There will be no returned data for this event.
  */
+#ifdef __wasm__
 inline void revert() {
     asm("unreachable");
 }
+#else
+// native builds get revert from the host implementation, such as the simulator in sim/
+void revert();
+#endif
 
 #ifdef __cplusplus
 }
@@ -4,7 +4,7 @@
 /**
  * stylus_utils.h defines a few high-level useful utils for stylus smart contracts
  * 
- * requires: bebi.h(string.h), hostio, stylus_types
+ * requires: bebi.h(string.h), hostio, stylus_types, selectors.h, context.h
  * c-file: utils.c
  */
 
@@ -13,6 +13,7 @@
 #include <stylus_types.h>
 #include <hostio.h>
 #include <bebi.h>
+#include <context.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -20,9 +21,11 @@ extern "C" {
 
 /**
  * sets message sender inside a padded 32-byte array
+ * the msg_sender hostio is called at most once per call, see context.h
  */
 inline void msg_sender_padded(bebi sender) {
-    msg_sender(sender+12);
+    __builtin_memset(sender, 0, 12);
+    __builtin_memcpy(sender + 12, context_msg_sender(), 20);
 }
 
 /**
@@ -0,0 +1,587 @@
+// Copyright 2022-2023, Offchain Labs, Inc.
+// For licensing, see https://github.com/stylus-sdk-c/blob/stylus/licenses/COPYRIGHT.md
+
+// this file defines the hostios, which must not be wrapped in STYLUS_TRACE builds
+#define STYLUS_TRACE_IMPL
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <stylus_sim.h>
+#include <hostio.h>
+#include <stylus_debug.h>
+#include <stylus_types.h>
+#include <keccak.h>
+#include <deploy.h>
+#include <context.h>
+
+// provided by the contract, see ENTRYPOINT in stylus_entry.h
+extern int user_entrypoint(size_t args_len);
+
+sim_env sim_context;
+
+/**
+ * growable byte buffer
+ */
+typedef struct sim_buf {
+    uint8_t *data;
+    size_t len;
+    size_t cap;
+} sim_buf;
+
+static void buf_set(sim_buf *buf, const uint8_t *data, size_t len) {
+    if (len > buf->cap) {
+        buf->data = realloc(buf->data, len);
+        buf->cap = len;
+    }
+    if (len > 0) {
+        memcpy(buf->data, data, len);
+    }
+    buf->len = len;
+}
+
+/**
+ * Storage: open addressing map from 32-byte keys to 32-byte values.
+ * "original" and "epoch" track the value at the start of the current call, and whether the
+ * slot was accessed in it (warm), for EIP-2929/2200 style pricing.
+ */
+typedef struct slot_entry {
+    bebi32 key;
+    bebi32 value;
+    bebi32 original;
+    uint64_t epoch;
+    bool used;
+} slot_entry;
+
+static slot_entry *slots;
+static size_t slots_cap;
+static size_t slots_len;
+static uint64_t epoch;
+
+// undo log for storage writes of the current call
+typedef struct journal_entry {
+    bebi32 key;
+    bebi32 prev;
+} journal_entry;
+
+static journal_entry *journal;
+static size_t journal_len;
+static size_t journal_cap;
+
+typedef struct sim_account {
+    uint8_t address[20];
+    bebi32 balance;
+    bebi32 codehash;
+} sim_account;
+
+static sim_account *accounts;
+static size_t accounts_len;
+
+static sim_log *logs;
+static size_t logs_len;
+static size_t logs_cap;
+
+static const uint8_t *call_args;
+static size_t call_args_len;
+static sim_buf result;
+static sim_buf return_data;
+
+static sim_stats stats;
+static uint64_t ink_left;
+static jmp_buf revert_jmp;
+static bool in_call;
+
+static uint64_t slot_hash(const uint8_t *key) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (int i = 0; i < 32; i++) {
+        hash = (hash ^ key[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static slot_entry *slot_find(const uint8_t *key, bool insert);
+
+static void slots_grow() {
+    slot_entry *old = slots;
+    size_t old_cap = slots_cap;
+    slots_cap = old_cap ? old_cap * 2 : 64;
+    slots = calloc(slots_cap, sizeof(slot_entry));
+    slots_len = 0;
+    for (size_t i = 0; i < old_cap; i++) {
+        if (old[i].used) {
+            *slot_find(old[i].key, true) = old[i];
+        }
+    }
+    free(old);
+}
+
+static slot_entry *slot_find(const uint8_t *key, bool insert) {
+    if (insert && (slots_len + 1) * 4 > slots_cap * 3) {
+        slots_grow();
+    }
+    if (slots_cap == 0) {
+        return NULL;
+    }
+    size_t idx = slot_hash(key) & (slots_cap - 1);
+    while (slots[idx].used) {
+        if (memcmp(slots[idx].key, key, 32) == 0) {
+            return &slots[idx];
+        }
+        idx = (idx + 1) & (slots_cap - 1);
+    }
+    if (!insert) {
+        return NULL;
+    }
+    slot_entry *entry = &slots[idx];
+    memset(entry, 0, sizeof(*entry));
+    memcpy(entry->key, key, 32);
+    entry->used = true;
+    slots_len++;
+    return entry;
+}
+
+static sim_account *account_find(const uint8_t *address, bool insert) {
+    for (size_t i = 0; i < accounts_len; i++) {
+        if (memcmp(accounts[i].address, address, 20) == 0) {
+            return &accounts[i];
+        }
+    }
+    if (!insert) {
+        return NULL;
+    }
+    accounts = realloc(accounts, (accounts_len + 1) * sizeof(sim_account));
+    sim_account *account = &accounts[accounts_len++];
+    memset(account, 0, sizeof(*account));
+    memcpy(account->address, address, 20);
+    return account;
+}
+
+void revert() {
+    if (!in_call) {
+        abort();
+    }
+    longjmp(revert_jmp, 1);
+}
+
+static void charge(sim_hostio hostio, uint64_t gas) {
+    stats.hostio_calls[hostio]++;
+    uint64_t ink = sim_context.costs.hostio + gas * sim_context.ink_price;
+    if (ink > ink_left) {
+        ink_left = 0;
+        stats.out_of_ink = true;
+        revert();
+    }
+    ink_left -= ink;
+}
+
+static void rollback(size_t logs_before) {
+    while (journal_len > 0) {
+        journal_len--;
+        slot_entry *entry = slot_find(journal[journal_len].key, true);
+        memcpy(entry->value, journal[journal_len].prev, 32);
+    }
+    while (logs_len > logs_before) {
+        logs_len--;
+        free(logs[logs_len].data);
+    }
+}
+
+void sim_reset() {
+    free(slots);
+    slots = NULL;
+    slots_cap = 0;
+    slots_len = 0;
+    journal_len = 0;
+    free(accounts);
+    accounts = NULL;
+    accounts_len = 0;
+    sim_clear_logs();
+    memset(&stats, 0, sizeof(stats));
+    memset(&sim_context, 0, sizeof(sim_context));
+    sim_context.chainid = 412346;
+    sim_context.block_number = 1;
+    sim_context.block_timestamp = 1700000000;
+    sim_context.block_gas_limit = 1125899906842624ULL;
+    sim_context.ink_price = 10000;
+    sim_context.ink_limit = 30000000ULL * 10000;
+    sim_context.create_nonce = 1;
+    sim_context.costs = (sim_costs) {
+        .hostio = 8400,
+        .sload_cold = 2100,
+        .sload_warm = 100,
+        .sstore_set = 20000,
+        .sstore_reset = 2900,
+        .sstore_warm = 100,
+        .keccak_base = 30,
+        .keccak_word = 6,
+        .log_base = 375,
+        .log_topic = 375,
+        .log_byte = 8,
+        .call_base = 2600,
+        .create_base = 32000,
+    };
+}
+
+int sim_call(const uint8_t *args, size_t args_len, const uint8_t **result_out, size_t *result_len_out) {
+    size_t logs_before = logs_len;
+    memset(&stats, 0, sizeof(stats));
+    ink_left = sim_context.ink_limit;
+    epoch++;
+    journal_len = 0;
+    call_args = args;
+    call_args_len = args_len;
+    result.len = 0;
+    return_data.len = 0;
+    // on-chain each call gets a fresh instance, and so an empty context cache
+    context_reset();
+
+    int status;
+    in_call = true;
+    if (setjmp(revert_jmp) == 0) {
+        status = user_entrypoint(args_len);
+    } else {
+        status = 1;
+        result.len = 0;
+    }
+    in_call = false;
+
+    if (status != 0) {
+        rollback(logs_before);
+    }
+    journal_len = 0;
+    stats.ink_used = sim_context.ink_limit - ink_left;
+    *result_out = result.data;
+    *result_len_out = result.len;
+    return status;
+}
+
+const sim_stats *sim_last_stats() {
+    return &stats;
+}
+
+#define SIM_HOSTIO_NAME(name) #name,
+static const char *hostio_names[SIM_HOSTIO_COUNT] = {
+    SIM_HOSTIOS(SIM_HOSTIO_NAME)
+};
+
+const char *sim_hostio_name(sim_hostio hostio) {
+    return hostio < SIM_HOSTIO_COUNT ? hostio_names[hostio] : "unknown";
+}
+
+void sim_storage_get(const uint8_t *key, uint8_t *value_out) {
+    slot_entry *entry = slot_find(key, false);
+    if (entry == NULL) {
+        memset(value_out, 0, 32);
+        return;
+    }
+    memcpy(value_out, entry->value, 32);
+}
+
+void sim_storage_set(const uint8_t *key, const uint8_t *value) {
+    memcpy(slot_find(key, true)->value, value, 32);
+}
+
+void sim_set_balance(const uint8_t *address, bebi32 const balance) {
+    memcpy(account_find(address, true)->balance, balance, 32);
+}
+
+void sim_set_codehash(const uint8_t *address, bebi32 const codehash) {
+    memcpy(account_find(address, true)->codehash, codehash, 32);
+}
+
+size_t sim_log_count() {
+    return logs_len;
+}
+
+const sim_log *sim_get_log(size_t index) {
+    return index < logs_len ? &logs[index] : NULL;
+}
+
+void sim_clear_logs() {
+    for (size_t i = 0; i < logs_len; i++) {
+        free(logs[i].data);
+    }
+    logs_len = 0;
+}
+
+void sim_set_return_data(const uint8_t *data, size_t len) {
+    buf_set(&return_data, data, len);
+}
+
+/**
+ * Host I/O implementation
+ */
+
+// marks the slot warm, and snapshots its value at the start of the call
+static slot_entry *slot_access(const uint8_t *key, bool *cold_out) {
+    slot_entry *entry = slot_find(key, true);
+    *cold_out = (entry->epoch != epoch);
+    if (*cold_out) {
+        entry->epoch = epoch;
+        memcpy(entry->original, entry->value, 32);
+    }
+    return entry;
+}
+
+void account_balance(const uint8_t *address, uint8_t *dest) {
+    charge(SIM_HOSTIO_account_balance, sim_context.costs.call_base);
+    sim_account *account = account_find(address, false);
+    if (account == NULL) {
+        memset(dest, 0, 32);
+        return;
+    }
+    memcpy(dest, account->balance, 32);
+}
+
+void account_codehash(const uint8_t *address, uint8_t *dest) {
+    charge(SIM_HOSTIO_account_codehash, sim_context.costs.call_base);
+    sim_account *account = account_find(address, false);
+    if (account == NULL) {
+        memset(dest, 0, 32);
+        return;
+    }
+    memcpy(dest, account->codehash, 32);
+}
+
+void storage_load_bytes32(const uint8_t *key, uint8_t *dest) {
+    bool cold;
+    slot_entry *entry = slot_access(key, &cold);
+    charge(SIM_HOSTIO_storage_load_bytes32, cold ? sim_context.costs.sload_cold : sim_context.costs.sload_warm);
+    memcpy(dest, entry->value, 32);
+}
+
+void storage_store_bytes32(const uint8_t *key, const uint8_t *value) {
+    bool cold;
+    slot_entry *entry = slot_access(key, &cold);
+    uint64_t gas = sim_context.costs.sstore_warm;
+    bool dirty = memcmp(entry->value, entry->original, 32) != 0;
+    if (!dirty && memcmp(entry->value, value, 32) != 0) {
+        gas = bebi32_is_zero(entry->original) ? sim_context.costs.sstore_set : sim_context.costs.sstore_reset;
+    }
+    if (cold) {
+        gas += sim_context.costs.sload_cold;
+    }
+    charge(SIM_HOSTIO_storage_store_bytes32, gas);
+    if (journal_len == journal_cap) {
+        journal_cap = journal_cap ? journal_cap * 2 : 64;
+        journal = realloc(journal, journal_cap * sizeof(journal_entry));
+    }
+    memcpy(journal[journal_len].key, key, 32);
+    memcpy(journal[journal_len].prev, entry->value, 32);
+    journal_len++;
+    memcpy(entry->value, value, 32);
+}
+
+void block_basefee(uint8_t *basefee) {
+    charge(SIM_HOSTIO_block_basefee, 0);
+    memcpy(basefee, sim_context.block_basefee, 32);
+}
+
+uint64_t chainid() {
+    charge(SIM_HOSTIO_chainid, 0);
+    return sim_context.chainid;
+}
+
+void block_coinbase(uint8_t *coinbase) {
+    charge(SIM_HOSTIO_block_coinbase, 0);
+    memcpy(coinbase, sim_context.block_coinbase, 20);
+}
+
+uint64_t block_gas_limit() {
+    charge(SIM_HOSTIO_block_gas_limit, 0);
+    return sim_context.block_gas_limit;
+}
+
+uint64_t block_number() {
+    charge(SIM_HOSTIO_block_number, 0);
+    return sim_context.block_number;
+}
+
+uint64_t block_timestamp() {
+    charge(SIM_HOSTIO_block_timestamp, 0);
+    return sim_context.block_timestamp;
+}
+
+static uint8_t sub_call(sim_call_kind kind, const uint8_t *contract, const uint8_t *calldata,
+                        size_t calldata_len, const uint8_t *value, size_t *return_data_len) {
+    return_data.len = 0;
+    uint8_t status = 1;
+    if (sim_context.call_handler != NULL) {
+        status = sim_context.call_handler(sim_context.call_handler_ctx, kind, contract, calldata, calldata_len, value);
+    }
+    *return_data_len = return_data.len;
+    return status;
+}
+
+uint8_t call_contract(const uint8_t *contract, const uint8_t *calldata, const size_t calldata_len,
+                      const uint8_t *value, const uint64_t gas, size_t *return_data_len) {
+    charge(SIM_HOSTIO_call_contract, sim_context.costs.call_base);
+    return sub_call(SIM_CALL, contract, calldata, calldata_len, value, return_data_len);
+}
+
+void contract_address(uint8_t *address) {
+    charge(SIM_HOSTIO_contract_address, 0);
+    memcpy(address, sim_context.contract_address, 20);
+}
+
+// deploys succeed unless the address already has code. The codehash recorded is that of
+// the init code, as init code is not executed.
+static void deploy(const uint8_t *code, size_t code_len, const uint8_t *address, uint8_t *contract) {
+    sim_account *account = account_find(address, true);
+    if (!bebi32_is_zero(account->codehash)) {
+        memset(contract, 0, 20);
+        return;
+    }
+    keccak256_wasm(code, code_len, account->codehash);
+    memcpy(contract, address, 20);
+}
+
+void create1(const uint8_t *code, const size_t code_len, const uint8_t *endowment,
+             uint8_t *contract, size_t *revert_data_len) {
+    charge(SIM_HOSTIO_create1, sim_context.costs.create_base);
+    uint8_t address[20];
+    create1_address(sim_context.contract_address, sim_context.create_nonce++, address);
+    return_data.len = 0;
+    *revert_data_len = 0;
+    deploy(code, code_len, address, contract);
+}
+
+void create2(const uint8_t *code, const size_t code_len, const uint8_t *endowment,
+             const uint8_t *salt, uint8_t *contract, size_t *revert_data_len) {
+    charge(SIM_HOSTIO_create2, sim_context.costs.create_base);
+    bebi32 code_hash;
+    keccak256_wasm(code, code_len, code_hash);
+    uint8_t address[20];
+    create2_address(sim_context.contract_address, salt, code_hash, address);
+    return_data.len = 0;
+    *revert_data_len = 0;
+    deploy(code, code_len, address, contract);
+}
+
+uint8_t delegate_call_contract(const uint8_t *contract, const uint8_t *calldata, const size_t calldata_len,
+                               const uint64_t gas, size_t *return_data_len) {
+    charge(SIM_HOSTIO_delegate_call_contract, sim_context.costs.call_base);
+    return sub_call(SIM_DELEGATE_CALL, contract, calldata, calldata_len, NULL, return_data_len);
+}
+
+void emit_log(uint8_t *data, size_t len, size_t topics) {
+    charge(SIM_HOSTIO_emit_log, sim_context.costs.log_base + topics * sim_context.costs.log_topic
+                                + len * sim_context.costs.log_byte);
+    if (topics > 4 || len < topics * 32) {
+        revert();
+    }
+    if (logs_len == logs_cap) {
+        logs_cap = logs_cap ? logs_cap * 2 : 16;
+        logs = realloc(logs, logs_cap * sizeof(sim_log));
+    }
+    sim_log *log = &logs[logs_len++];
+    log->data = malloc(len ? len : 1);
+    memcpy(log->data, data, len);
+    log->len = len;
+    log->topics = topics;
+}
+
+uint64_t evm_gas_left() {
+    charge(SIM_HOSTIO_evm_gas_left, 0);
+    return ink_left / sim_context.ink_price;
+}
+
+uint64_t evm_ink_left() {
+    charge(SIM_HOSTIO_evm_ink_left, 0);
+    return ink_left;
+}
+
+void memory_grow(const uint16_t pages) {
+    charge(SIM_HOSTIO_memory_grow, 0);
+}
+
+void msg_sender(const uint8_t *sender) {
+    charge(SIM_HOSTIO_msg_sender, 0);
+    memcpy((uint8_t *)sender, sim_context.msg_sender, 20);
+}
+
+void msg_value(const uint8_t *value) {
+    charge(SIM_HOSTIO_msg_value, 0);
+    memcpy((uint8_t *)value, sim_context.msg_value, 32);
+}
+
+void native_keccak256(const uint8_t *bytes, size_t len, uint8_t *output) {
+    charge(SIM_HOSTIO_native_keccak256, sim_context.costs.keccak_base + (len + 31) / 32 * sim_context.costs.keccak_word);
+    keccak256_wasm(bytes, len, output);
+}
+
+void read_args(const uint8_t *data) {
+    charge(SIM_HOSTIO_read_args, 0);
+    if (call_args_len > 0) {
+        memcpy((uint8_t *)data, call_args, call_args_len);
+    }
+}
+
+size_t read_return_data(uint8_t *dest, size_t offset, size_t size) {
+    charge(SIM_HOSTIO_read_return_data, 0);
+    if (offset > return_data.len) {
+        revert();
+    }
+    size_t available = return_data.len - offset;
+    if (size > available) {
+        size = available;
+    }
+    if (size > 0) {
+        memcpy(dest, return_data.data + offset, size);
+    }
+    return size;
+}
+
+void write_result(const uint8_t *data, size_t len) {
+    charge(SIM_HOSTIO_write_result, 0);
+    buf_set(&result, data, len);
+}
+
+size_t return_data_size() {
+    charge(SIM_HOSTIO_return_data_size, 0);
+    return return_data.len;
+}
+
+uint8_t static_call_contract(const uint8_t *contract, const uint8_t *calldata, const size_t calldata_len,
+                             const uint64_t gas, size_t *return_data_len) {
+    charge(SIM_HOSTIO_static_call_contract, sim_context.costs.call_base);
+    return sub_call(SIM_STATIC_CALL, contract, calldata, calldata_len, NULL, return_data_len);
+}
+
+void tx_gas_price(uint8_t *gas_price) {
+    charge(SIM_HOSTIO_tx_gas_price, 0);
+    memcpy(gas_price, sim_context.tx_gas_price, 32);
+}
+
+uint64_t tx_ink_price() {
+    charge(SIM_HOSTIO_tx_ink_price, 0);
+    return sim_context.ink_price;
+}
+
+void tx_origin(uint8_t *origin) {
+    charge(SIM_HOSTIO_tx_origin, 0);
+    memcpy(origin, sim_context.tx_origin, 20);
+}
+
+// console, printed to stderr
+
+void log_f32(float *value) {
+    fprintf(stderr, "log_f32: %f\n", *value);
+}
+
+void log_f64(double *value) {
+    fprintf(stderr, "log_f64: %f\n", *value);
+}
+
+void log_i32(int32_t value) {
+    fprintf(stderr, "log_i32: %d\n", value);
+}
+
+void log_i64(int64_t value) {
+    fprintf(stderr, "log_i64: %lld\n", (long long)value);
+}
+
+void log_txt(const uint8_t *text, size_t len) {
+    fprintf(stderr, "%.*s\n", (int)len, (const char *)text);
+}
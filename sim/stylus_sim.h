@@ -0,0 +1,171 @@
+// Copyright 2022-2023, Offchain Labs, Inc.
+// For licensing, see https://github.com/stylus-sdk-c/blob/stylus/licenses/COPYRIGHT.md
+
+#ifndef __STYLUS_SIM_H
+#define __STYLUS_SIM_H
+
+/**
+ * stylus_sim.h is a native (non-wasm) implementation of every hostio in hostio.h
+ *
+ * A contract compiled natively and linked against libstylus_sim.a can be called without a node,
+ * e.g. from unit tests or fuzzers. The simulator keeps:
+ *  * an in-memory storage map, rolled back when a call reverts
+ *  * a configurable msg/tx/block context (sim_env)
+ *  * a recorder for emitted logs
+ *  * a handler for sub-calls (call/static_call/delegate_call), supplied by the test
+ *  * ink accounting for hostios
+ *
+ * The console functions of stylus_debug.h print to stderr.
+ *
+ * Ink is only charged for hostios, using the approximate costs in sim_costs.
+ * Native code does not meter wasm instructions.
+ *
+ * Single threaded, one simulated chain per process.
+ *
+ * requires: hostio.h, stylus_debug.h, stylus_types.h, bebi.h, keccak.h, deploy.h, context.h
+ * c-file: stylus_sim.c
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <bebi.h>
+#include <hostio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum sim_call_kind {
+    SIM_CALL = 0,
+    SIM_STATIC_CALL,
+    SIM_DELEGATE_CALL,
+} sim_call_kind;
+
+/**
+ * Handles a sub-call made by the contract. Return data is set with sim_set_return_data.
+ * value is NULL for static and delegate calls.
+ * Returns the call status: 0 for success, nonzero for failure.
+ */
+typedef uint8_t (*sim_call_handler)(void *ctx, sim_call_kind kind, const uint8_t *target,
+                                    const uint8_t *calldata, size_t calldata_len, const uint8_t *value);
+
+/**
+ * Ink charged by the simulator.
+ * Every hostio costs "hostio" ink. EVM-priced operations also cost the listed gas,
+ * converted to ink using sim_env.ink_price.
+ * Defaults approximate Stylus and EVM (EIP-2929) pricing, they are not exact.
+ */
+typedef struct sim_costs {
+    uint64_t hostio;
+    uint64_t sload_cold;
+    uint64_t sload_warm;
+    uint64_t sstore_set;
+    uint64_t sstore_reset;
+    uint64_t sstore_warm;
+    uint64_t keccak_base;
+    uint64_t keccak_word;
+    uint64_t log_base;
+    uint64_t log_topic;
+    uint64_t log_byte;
+    uint64_t call_base;
+    uint64_t create_base;
+} sim_costs;
+
+/**
+ * Context of the simulated chain. Set fields directly between calls.
+ * Addresses are 20 bytes.
+ */
+typedef struct sim_env {
+    uint8_t msg_sender[20];
+    bebi32 msg_value;
+    uint8_t contract_address[20];
+    uint8_t tx_origin[20];
+    bebi32 tx_gas_price;
+    bebi32 block_basefee;
+    uint8_t block_coinbase[20];
+    uint64_t chainid;
+    uint64_t block_number;
+    uint64_t block_timestamp;
+    uint64_t block_gas_limit;
+    uint64_t ink_price;
+    uint64_t ink_limit;
+    uint64_t create_nonce;
+    sim_costs costs;
+    sim_call_handler call_handler;
+    void *call_handler_ctx;
+} sim_env;
+
+extern sim_env sim_context;
+
+// hostios, in the order of hostio.h
+#define SIM_HOSTIOS(X) STYLUS_HOSTIOS(X)
+
+#define SIM_HOSTIO_ID(name) SIM_HOSTIO_##name,
+typedef enum sim_hostio {
+    SIM_HOSTIOS(SIM_HOSTIO_ID)
+    SIM_HOSTIO_COUNT
+} sim_hostio;
+#undef SIM_HOSTIO_ID
+
+/**
+ * Statistics of the last sim_call
+ */
+typedef struct sim_stats {
+    uint64_t ink_used;
+    bool out_of_ink;
+    uint64_t hostio_calls[SIM_HOSTIO_COUNT];
+} sim_stats;
+
+typedef struct sim_log {
+    uint8_t *data;
+    size_t len;
+    size_t topics;
+} sim_log;
+
+/**
+ * clears storage, logs, accounts and statistics, and sets sim_context to defaults
+ * must be called before any other sim_* function
+ */
+void sim_reset();
+
+/**
+ * calls the contract's user_entrypoint with args, as a new transaction.
+ *
+ * result points to the data passed to write_result, and stays valid until the next sim_call.
+ * returns the status returned by user_entrypoint, or 1 if the contract reverted.
+ * A failing call (including reverts and running out of ink) undoes its storage changes and logs.
+ * Not reentrant: a sim_call_handler must not call sim_call.
+ */
+int sim_call(const uint8_t *args, size_t args_len, const uint8_t **result, size_t *result_len);
+
+const sim_stats *sim_last_stats();
+
+/**
+ * return the name of a hostio, e.g. "storage_load_bytes32"
+ */
+const char *sim_hostio_name(sim_hostio hostio);
+
+/**
+ * direct access to storage, not charged and not journaled
+ */
+void sim_storage_get(const uint8_t *key, uint8_t *value_out);
+void sim_storage_set(const uint8_t *key, const uint8_t *value);
+
+void sim_set_balance(const uint8_t *address, bebi32 const balance);
+void sim_set_codehash(const uint8_t *address, bebi32 const codehash);
+
+size_t sim_log_count();
+const sim_log *sim_get_log(size_t index);
+void sim_clear_logs();
+
+/**
+ * sets the data returned by the current sub-call. Called from a sim_call_handler.
+ */
+void sim_set_return_data(const uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __STYLUS_SIM_H
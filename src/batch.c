@@ -0,0 +1,70 @@
+#include <batch.h>
+#include <storage.h>
+#include <string.h>
+#include <bebi.h>
+#include "heapsort.h"
+
+void batch_load(batch_update *updates, const uint8_t *keys, const uint8_t *amounts, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        updates[i].key = keys + 32 * i;
+        memcpy(updates[i].amount, amounts + 32 * i, 32);
+    }
+}
+
+static inline int key_cmp(const batch_update *a, const batch_update *b) {
+    return memcmp(a->key, b->key, 32);
+}
+
+static int update_cmp(const void *a, const void *b) {
+    return key_cmp((const batch_update *)a, (const batch_update *)b);
+}
+
+void batch_sort(batch_update *updates, size_t n) {
+    heap_sort(updates, n, sizeof(batch_update), update_cmp);
+}
+
+int batch_merge(batch_update *updates, size_t n, size_t *n_out, bebi32 total_out) {
+    batch_sort(updates, n);
+    if (total_out != NULL) {
+        memset(total_out, 0, 32);
+    }
+    size_t out = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (total_out != NULL && bebi32_add(total_out, updates[i].amount)) {
+            return -1;
+        }
+        if (out > 0 && key_cmp(&updates[out - 1], &updates[i]) == 0) {
+            if (bebi32_add(updates[out - 1].amount, updates[i].amount)) {
+                return -1;
+            }
+            continue;
+        }
+        // a zero amount left behind by the previous key is overwritten
+        if (out > 0 && bebi32_is_zero(updates[out - 1].amount)) {
+            out--;
+        }
+        if (out != i) {
+            updates[out] = updates[i];
+        }
+        out++;
+    }
+    if (out > 0 && bebi32_is_zero(updates[out - 1].amount)) {
+        out--;
+    }
+    *n_out = out;
+    return 0;
+}
+
+int batch_add_to_map(bebi32 const map_base, const batch_update *updates, size_t n) {
+    bebi32 slot;
+    bebi32 value;
+    for (size_t i = 0; i < n; i++) {
+        map_slot(map_base, updates[i].key, 32, slot);
+        storage_load_bytes32(slot, value);
+        if (bebi32_add(value, updates[i].amount)) {
+            return -1;
+        }
+        storage_store_bytes32(slot, value);
+    }
+    return 0;
+}
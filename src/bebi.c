@@ -1,6 +1,53 @@
 #include <string.h>
+// with STYLUS_SIZE_OPT, bebi.h defines its helpers here, out-of-line
+#define BEBI_IMPL
 #include <bebi.h>
 
+#ifdef STYLUS_SIZE_OPT
+
+// one loop for every width, instead of the unrolled versions in bebi.h
+static void set_be(bebi dst, size_t offset, uint64_t val, size_t bytes) {
+    while (bytes > 0) {
+        bytes--;
+        dst[offset + bytes] = val & 0xff;
+        val >>= 8;
+    }
+}
+
+static uint64_t get_be(const bebi src, size_t offset, size_t bytes) {
+    uint64_t val = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        val = (val << 8) | src[offset + i];
+    }
+    return val;
+}
+
+void bebi_set_u16(bebi dst, size_t offset, uint16_t val) {
+    set_be(dst, offset, val, 2);
+}
+
+uint16_t bebi_get_u16(const bebi src, size_t offset) {
+    return get_be(src, offset, 2);
+}
+
+void bebi_set_u32(bebi dst, size_t offset, uint32_t val) {
+    set_be(dst, offset, val, 4);
+}
+
+uint32_t bebi_get_u32(const bebi src, size_t offset) {
+    return get_be(src, offset, 4);
+}
+
+void bebi_set_u64(bebi dst, size_t offset, uint64_t val) {
+    set_be(dst, offset, val, 8);
+}
+
+uint64_t bebi_get_u64(const bebi src, size_t offset) {
+    return get_be(src, offset, 8);
+}
+
+#else
+
 extern inline int bebi_add(bebi lhs, size_t lhs_size, const bebi rhs, size_t rhs_size);
 extern inline int bebi_sub(bebi lhs, size_t lhs_size, const bebi rhs, size_t rhs_size);
 extern inline int bebi_cmp(const bebi lhs, size_t lhs_size, const bebi rhs, size_t rhs_size);
@@ -15,6 +62,8 @@ extern inline uint32_t bebi_get_u32(const bebi src, size_t offset);
 extern inline void bebi_set_u64(bebi dst, size_t offset, uint64_t val);
 extern inline uint64_t bebi_get_u64(const bebi src, size_t offset);
 
+#endif // STYLUS_SIZE_OPT
+
 int bebi32_add(bebi32 lhs, const bebi32 rhs) {
     return bebi_add(lhs, 32, rhs, 32);
 }
@@ -0,0 +1,75 @@
+#include <call_memo.h>
+#include <keccak.h>
+#include <hostio.h>
+#include <string.h>
+
+void call_memo_init(call_memo *memo, call_memo_entry *entries, size_t entries_cap, uint8_t *buf, size_t buf_cap) {
+    memo->entries = entries;
+    memo->entries_cap = entries_cap;
+    memo->buf = buf;
+    memo->buf_cap = buf_cap;
+    call_memo_clear(memo);
+}
+
+void call_memo_clear(call_memo *memo) {
+    memo->count = 0;
+    memo->buf_used = 0;
+}
+
+// the window [offset, offset + size) cut at the end of the return data
+static size_t window_len(size_t return_data_len, size_t offset, size_t size) {
+    size_t available = return_data_len - offset;
+    return size < available ? size : available;
+}
+
+// newest entry of target and key whose window covers the requested one
+static const call_memo_entry *memo_find(const call_memo *memo, const uint8_t *target, const uint8_t *key,
+                                        size_t offset, size_t size) {
+    for (size_t i = memo->count; i > 0; i--) {
+        const call_memo_entry *entry = &memo->entries[i - 1];
+        if (memcmp(entry->key, key, 32) != 0 || memcmp(entry->target, target, 20) != 0 ||
+            offset > entry->return_data_len) {
+            continue;
+        }
+        size_t len = window_len(entry->return_data_len, offset, size);
+        if (offset >= entry->offset && offset + len <= entry->offset + entry->len) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+uint8_t call_memo_static_call(call_memo *memo, const uint8_t *target, const uint8_t *calldata,
+                              size_t calldata_len, uint64_t gas, uint8_t *dest, size_t offset, size_t size,
+                              size_t *return_data_len_out) {
+    bebi32 key;
+    keccak256(calldata, calldata_len, key);
+    const call_memo_entry *found = memo_find(memo, target, key, offset, size);
+    if (found != NULL) {
+        size_t len = window_len(found->return_data_len, offset, size);
+        memcpy(dest, found->data + (offset - found->offset), len);
+        *return_data_len_out = found->return_data_len;
+        return 0;
+    }
+
+    size_t return_data_len = 0;
+    uint8_t status = static_call_contract(target, calldata, calldata_len, gas, &return_data_len);
+    if (status != 0) {
+        return status;
+    }
+    size_t len = read_return_data(dest, offset, size);
+    *return_data_len_out = return_data_len;
+
+    if (memo->count < memo->entries_cap && len <= memo->buf_cap - memo->buf_used) {
+        call_memo_entry *entry = &memo->entries[memo->count++];
+        memcpy(entry->target, target, 20);
+        memcpy(entry->key, key, 32);
+        entry->return_data_len = return_data_len;
+        entry->offset = offset;
+        entry->len = len;
+        entry->data = memo->buf + memo->buf_used;
+        memcpy(memo->buf + memo->buf_used, dest, len);
+        memo->buf_used += len;
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <deploy.h>
+#include <hostio.h>
+#include <string.h>
+#include <bebi.h>
+
+// keccak("") - the codehash of an account without code
+static const uint8_t empty_code_hash[32] = {
+    0xc5, 0xd2, 0x46, 0x01, 0x86, 0xf7, 0x23, 0x3c, 0x92, 0x7e, 0x7d, 0xb2, 0xdc, 0xc7, 0x03, 0xc0,
+    0xe5, 0x00, 0xb6, 0x53, 0xca, 0x82, 0x27, 0x3b, 0x7b, 0xfa, 0xd8, 0x04, 0x5d, 0x85, 0xa4, 0x70,
+};
+
+void create1_address(const uint8_t *deployer, uint64_t nonce, uint8_t *address_out) {
+    // rlp list of: a 20-byte string, a 0..8 byte integer. Never longer than 55 bytes.
+    uint8_t buf[1 + 21 + 9];
+    size_t len = 1;
+    buf[len++] = 0x80 + 20;
+    memcpy(buf + len, deployer, 20);
+    len += 20;
+    if (nonce == 0) {
+        buf[len++] = 0x80;
+    } else if (nonce < 0x80) {
+        buf[len++] = (uint8_t)nonce;
+    } else {
+        uint8_t nonce_bytes[8];
+        bebi_set_u64(nonce_bytes, 0, nonce);
+        size_t skip = 0;
+        while (nonce_bytes[skip] == 0) {
+            skip++;
+        }
+        buf[len++] = 0x80 + (8 - skip);
+        memcpy(buf + len, nonce_bytes + skip, 8 - skip);
+        len += 8 - skip;
+    }
+    buf[0] = 0xc0 + (len - 1);
+    bebi32 hash;
+    native_keccak256(buf, len, hash);
+    memcpy(address_out, hash + 12, 20);
+}
+
+void create2_address(const uint8_t *deployer, bebi32 const salt, bebi32 const init_code_hash, uint8_t *address_out) {
+    uint8_t buf[1 + 20 + 32 + 32];
+    buf[0] = 0xff;
+    memcpy(buf + 1, deployer, 20);
+    memcpy(buf + 21, salt, 32);
+    memcpy(buf + 53, init_code_hash, 32);
+    bebi32 hash;
+    native_keccak256(buf, sizeof(buf), hash);
+    memcpy(address_out, hash + 12, 20);
+}
+
+void create2_factory_init(create2_factory *factory, const uint8_t *code, size_t code_len, const uint8_t *code_hash) {
+    factory->code = code;
+    factory->code_len = code_len;
+    factory->code_hash_set = (code_hash != NULL);
+    if (code_hash != NULL) {
+        memcpy(factory->code_hash, code_hash, 32);
+    }
+    factory->deployer_set = false;
+}
+
+void create2_factory_predict(create2_factory *factory, bebi32 const salt, uint8_t *address_out) {
+    if (!factory->code_hash_set) {
+        native_keccak256(factory->code, factory->code_len, factory->code_hash);
+        factory->code_hash_set = true;
+    }
+    if (!factory->deployer_set) {
+        contract_address(factory->deployer);
+        factory->deployer_set = true;
+    }
+    create2_address(factory->deployer, salt, factory->code_hash, address_out);
+}
+
+int create2_factory_deploy(create2_factory *factory, const uint8_t *endowment, bebi32 const salt,
+                           uint8_t *address_out, size_t *revert_data_len) {
+    create2_factory_predict(factory, salt, address_out);
+    bebi32 codehash;
+    account_codehash(address_out, codehash);
+    if (!bebi32_is_zero(codehash) && bebi32_cmp(codehash, empty_code_hash) != 0) {
+        *revert_data_len = 0;
+        return 1;
+    }
+    uint8_t deployed[20];
+    create2(factory->code, factory->code_len, endowment, salt, deployed, revert_data_len);
+    if (bebi_is_zero(deployed, 20)) {
+        return -1;
+    }
+    memcpy(address_out, deployed, 20);
+    return 0;
+}
@@ -0,0 +1,131 @@
+#include <enumerable_set.h>
+#include <storage.h>
+#include <hostio.h>
+#include <string.h>
+#include <bebi.h>
+
+void enumerable_set_init(enumerable_set *set, bebi32 const slot) {
+    memcpy(set->values_slot, slot, 32);
+    dynamic_array_base_slot(slot, set->values_base);
+    memcpy(set->positions_slot, slot, 32);
+    bebi32_add_u64(set->positions_slot, 1);
+    set->reserved = 0;
+}
+
+static void value_slot(const enumerable_set *set, uint64_t index, bebi32 slot_out) {
+    memcpy(slot_out, set->values_base, 32);
+    bebi32_add_u64(slot_out, index);
+}
+
+static void store_u64(const uint8_t *slot, uint64_t val) {
+    bebi32 buf;
+    bebi32_set_u64(buf, val);
+    storage_store_bytes32(slot, buf);
+}
+
+static uint64_t load_u64(const uint8_t *slot) {
+    bebi32 buf;
+    storage_load_bytes32(slot, buf);
+    return bebi32_get_u64(buf);
+}
+
+// length of the array, reserved entries included
+static uint64_t array_length(const enumerable_set *set) {
+    return load_u64(set->values_slot);
+}
+
+bool enumerable_set_contains(const enumerable_set *set, const uint8_t *value) {
+    bebi32 position_slot;
+    map_slot(set->positions_slot, value, 32, position_slot);
+    return load_u64(position_slot) != 0;
+}
+
+uint64_t enumerable_set_length(const enumerable_set *set) {
+    uint64_t length = array_length(set);
+    return length > set->reserved ? length - set->reserved : 0;
+}
+
+int enumerable_set_add(const enumerable_set *set, const uint8_t *value) {
+    bebi32 position_slot;
+    map_slot(set->positions_slot, value, 32, position_slot);
+    if (load_u64(position_slot) != 0) {
+        return 0;
+    }
+    uint64_t index = array_length(set);
+    if (index < set->reserved) {
+        // the reserved entries were never pushed: the length skips over them, and they stay zero
+        index = set->reserved;
+    }
+    bebi32 slot;
+    value_slot(set, index, slot);
+    storage_store_bytes32(slot, value);
+    store_u64(set->values_slot, index + 1);
+    store_u64(position_slot, index + 1 - set->reserved);
+    return 1;
+}
+
+int enumerable_set_remove(const enumerable_set *set, const uint8_t *value) {
+    bebi32 position_slot;
+    map_slot(set->positions_slot, value, 32, position_slot);
+    uint64_t position = load_u64(position_slot);
+    if (position == 0) {
+        return 0;
+    }
+    uint64_t index = position - 1 + set->reserved;
+    uint64_t last = array_length(set) - 1;
+    bebi32 last_slot;
+    value_slot(set, last, last_slot);
+    if (index != last) {
+        // move the last value into the freed index
+        bebi32 last_value;
+        storage_load_bytes32(last_slot, last_value);
+        bebi32 slot;
+        value_slot(set, index, slot);
+        storage_store_bytes32(slot, last_value);
+        bebi32 last_position_slot;
+        map_slot(set->positions_slot, last_value, 32, last_position_slot);
+        store_u64(last_position_slot, position);
+    }
+    // pop: clear the last entry, as solidity does
+    bebi32 zero = {0};
+    storage_store_bytes32(last_slot, zero);
+    store_u64(set->values_slot, last);
+    storage_store_bytes32(position_slot, zero);
+    return 1;
+}
+
+int enumerable_set_at(const enumerable_set *set, uint64_t index, uint8_t *out) {
+    if (index >= enumerable_set_length(set)) {
+        return -1;
+    }
+    bebi32 slot;
+    value_slot(set, index + set->reserved, slot);
+    storage_load_bytes32(slot, out);
+    return 0;
+}
+
+void enumerable_set_cursor_init(enumerable_set_cursor *cursor, const enumerable_set *set, uint64_t start) {
+    uint64_t length = enumerable_set_length(set);
+    cursor->remaining = start < length ? length - start : 0;
+    value_slot(set, start + set->reserved, cursor->slot);
+}
+
+bool enumerable_set_next(enumerable_set_cursor *cursor, uint8_t *out) {
+    if (cursor->remaining == 0) {
+        return false;
+    }
+    storage_load_bytes32(cursor->slot, out);
+    bebi32_add_u64(cursor->slot, 1);
+    cursor->remaining--;
+    return true;
+}
+
+size_t enumerable_set_values(const enumerable_set *set, uint64_t start, uint8_t *out, size_t max) {
+    enumerable_set_cursor cursor;
+    enumerable_set_cursor_init(&cursor, set, start);
+    size_t count = 0;
+    while (count < max && enumerable_set_next(&cursor, out + 32 * count)) {
+        count++;
+    }
+    return count;
+}
@@ -0,0 +1,52 @@
+#ifndef __HEAPSORT_H
+#define __HEAPSORT_H
+
+/**
+ * heapsort.h is the in-place heapsort shared by the SDK sources (internal, not installed)
+ *
+ * O(n log n) in the worst case and no allocation, as qsort's interface:
+ * n elements of "size" bytes at base, ordered by cmp. The sort is not stable.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int (*heap_sort_cmp)(const void *a, const void *b);
+
+static inline void heap_sort_swap(uint8_t *a, uint8_t *b, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        uint8_t tmp = a[i];
+        a[i] = b[i];
+        b[i] = tmp;
+    }
+}
+
+static inline void heap_sort_sift_down(uint8_t *base, size_t root, size_t n, size_t size, heap_sort_cmp cmp) {
+    while (2 * root + 1 < n) {
+        size_t child = 2 * root + 1;
+        if (child + 1 < n && cmp(base + child * size, base + (child + 1) * size) < 0) {
+            child++;
+        }
+        if (cmp(base + root * size, base + child * size) >= 0) {
+            return;
+        }
+        heap_sort_swap(base + root * size, base + child * size, size);
+        root = child;
+    }
+}
+
+static inline void heap_sort(void *base, size_t n, size_t size, heap_sort_cmp cmp) {
+    uint8_t *bytes = (uint8_t *)base;
+    if (n < 2) {
+        return;
+    }
+    for (size_t i = n / 2; i > 0; i--) {
+        heap_sort_sift_down(bytes, i - 1, n, size, cmp);
+    }
+    for (size_t end = n - 1; end > 0; end--) {
+        heap_sort_swap(bytes, bytes + end * size, size);
+        heap_sort_sift_down(bytes, 0, end, size, cmp);
+    }
+}
+
+#endif // __HEAPSORT_H
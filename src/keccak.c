@@ -0,0 +1,168 @@
+#include <keccak.h>
+#include <string.h>
+
+#ifndef KECCAK256_WASM_BELOW
+#define KECCAK256_WASM_BELOW 0
+#endif
+
+const size_t keccak256_wasm_below = KECCAK256_WASM_BELOW;
+
+extern inline bool keccak256_in_wasm(size_t len);
+extern inline void keccak256(const uint8_t *data, size_t len, uint8_t *output);
+
+#define ROTL64(x, b) (uint64_t)( ((x) << (b)) | ( (x) >> (64 - (b))) )
+
+static const uint64_t round_constants[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+};
+
+// rho rotations, in the order lanes are visited by pi
+static const uint8_t rotations[24] = {
+    1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44,
+};
+
+// pi lane order
+static const uint8_t pi_lanes[24] = {
+    10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1,
+};
+
+void keccak_f1600(uint64_t state[25]) {
+    uint64_t bc[5];
+    for (int round = 0; round < 24; round++) {
+        // theta
+        for (int i = 0; i < 5; i++) {
+            bc[i] = state[i] ^ state[i + 5] ^ state[i + 10] ^ state[i + 15] ^ state[i + 20];
+        }
+        for (int i = 0; i < 5; i++) {
+            uint64_t t = bc[(i + 4) % 5] ^ ROTL64(bc[(i + 1) % 5], 1);
+            for (int j = 0; j < 25; j += 5) {
+                state[j + i] ^= t;
+            }
+        }
+        // rho and pi
+        uint64_t t = state[1];
+        for (int i = 0; i < 24; i++) {
+            int j = pi_lanes[i];
+            uint64_t next = state[j];
+            state[j] = ROTL64(t, rotations[i]);
+            t = next;
+        }
+        // chi
+        for (int j = 0; j < 25; j += 5) {
+            for (int i = 0; i < 5; i++) {
+                bc[i] = state[j + i];
+            }
+            for (int i = 0; i < 5; i++) {
+                state[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
+            }
+        }
+        // iota
+        state[0] ^= round_constants[round];
+    }
+}
+
+// lanes are little endian, as is wasm
+static inline void xor_byte(uint64_t state[25], size_t pos, uint8_t val) {
+    state[pos / 8] ^= (uint64_t)val << (8 * (pos % 8));
+}
+
+void keccak_sponge_init(keccak_sponge *sponge) {
+    memset(sponge, 0, sizeof(*sponge));
+}
+
+void keccak_sponge_absorb(keccak_sponge *sponge, const uint8_t *data, size_t len) {
+    size_t pos = sponge->pos;
+    // absorb whole lanes when aligned
+    while (len > 0) {
+        if (pos % 8 == 0 && len >= 8) {
+            uint64_t lane;
+            memcpy(&lane, data, 8);
+            sponge->state[pos / 8] ^= lane;
+            pos += 8;
+            data += 8;
+            len -= 8;
+        } else {
+            xor_byte(sponge->state, pos, *data);
+            pos++;
+            data++;
+            len--;
+        }
+        if (pos == KECCAK256_RATE) {
+            keccak_f1600(sponge->state);
+            pos = 0;
+        }
+    }
+    sponge->pos = pos;
+}
+
+void keccak_sponge_squeeze(keccak_sponge *sponge, uint8_t *out, size_t len) {
+    if (!sponge->squeezing) {
+        // keccak padding (not SHA3): 0x01 .. 0x80
+        xor_byte(sponge->state, sponge->pos, 0x01);
+        xor_byte(sponge->state, KECCAK256_RATE - 1, 0x80);
+        keccak_f1600(sponge->state);
+        sponge->pos = 0;
+        sponge->squeezing = true;
+    }
+    size_t pos = sponge->pos;
+    while (len > 0) {
+        if (pos == KECCAK256_RATE) {
+            keccak_f1600(sponge->state);
+            pos = 0;
+        }
+        *out = (uint8_t)(sponge->state[pos / 8] >> (8 * (pos % 8)));
+        out++;
+        pos++;
+        len--;
+    }
+    sponge->pos = pos;
+}
+
+void keccak256_wasm(const uint8_t *data, size_t len, uint8_t *output) {
+    keccak_sponge sponge;
+    keccak_sponge_init(&sponge);
+    keccak_sponge_absorb(&sponge, data, len);
+    keccak_sponge_squeeze(&sponge, output, 32);
+}
+
+void keccak256_init(keccak256_hasher *hasher, size_t len, uint8_t *buf, size_t cap) {
+    hasher->in_wasm = keccak256_in_wasm(len);
+    hasher->overflow = false;
+    hasher->buf = buf;
+    hasher->cap = cap;
+    hasher->len = 0;
+    if (hasher->in_wasm) {
+        keccak_sponge_init(&hasher->sponge);
+    }
+}
+
+int keccak256_update(keccak256_hasher *hasher, const uint8_t *data, size_t len) {
+    if (hasher->in_wasm) {
+        keccak_sponge_absorb(&hasher->sponge, data, len);
+        return 0;
+    }
+    if (hasher->overflow || len > hasher->cap - hasher->len) {
+        hasher->overflow = true;
+        return -1;
+    }
+    memcpy(hasher->buf + hasher->len, data, len);
+    hasher->len += len;
+    return 0;
+}
+
+int keccak256_final(keccak256_hasher *hasher, uint8_t *output) {
+    if (hasher->in_wasm) {
+        keccak_sponge_squeeze(&hasher->sponge, output, 32);
+        return 0;
+    }
+    if (hasher->overflow) {
+        return -1;
+    }
+    native_keccak256(hasher->buf, hasher->len, output);
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include <multicall.h>
+#include <hostio.h>
+#include <string.h>
+#include <bebi.h>
+
+#define MULTICALL_WORD 32
+// header: offset of the array, array length
+#define MULTICALL_HEADER (2 * MULTICALL_WORD)
+// each result: success, offset of bytes, bytes length
+#define MULTICALL_RESULT_HEADER (3 * MULTICALL_WORD)
+
+static const uint8_t zero_value[32];
+
+static size_t padded_len(size_t len) {
+    return (len + MULTICALL_WORD - 1) / MULTICALL_WORD * MULTICALL_WORD;
+}
+
+size_t multicall_output_size(size_t count, size_t return_data_len) {
+    // every result may add up to a word of padding
+    return MULTICALL_HEADER + count * (2 * MULTICALL_WORD + MULTICALL_RESULT_HEADER) + padded_len(return_data_len);
+}
+
+int multicall(const multicall_call *calls, size_t count, bool is_static,
+              uint8_t *out, size_t out_cap, size_t *out_len_out) {
+    size_t heads = MULTICALL_HEADER;
+    size_t tail = heads + count * MULTICALL_WORD;
+    // fail before making any call when possible: heads and result headers take a fixed size
+    if (out_cap < tail || (out_cap - tail) / MULTICALL_RESULT_HEADER < count) {
+        return -1;
+    }
+    if (is_static) {
+        for (size_t i = 0; i < count; i++) {
+            if (calls[i].value != NULL) {
+                return -1;
+            }
+        }
+    }
+    bebi32_set_u64(out, MULTICALL_WORD);
+    bebi32_set_u64(out + MULTICALL_WORD, count);
+
+    for (size_t i = 0; i < count; i++) {
+        const multicall_call *call = &calls[i];
+        size_t return_data_len = 0;
+        uint8_t status;
+        if (is_static) {
+            status = static_call_contract(call->target, call->calldata, call->calldata_len,
+                                          call->gas, &return_data_len);
+        } else {
+            const uint8_t *value = call->value != NULL ? call->value : zero_value;
+            status = call_contract(call->target, call->calldata, call->calldata_len,
+                                   value, call->gas, &return_data_len);
+        }
+        if (status != 0 && !call->allow_failure) {
+            *out_len_out = i;
+            return 1;
+        }
+        size_t padded = padded_len(return_data_len);
+        if (out_cap - tail < MULTICALL_RESULT_HEADER + padded) {
+            return -1;
+        }
+        // offsets in the array are relative to the first head
+        bebi32_set_u64(out + heads + i * MULTICALL_WORD, tail - heads);
+
+        uint8_t *result = out + tail;
+        bebi32_set_u8(result, status == 0 ? 1 : 0);
+        bebi32_set_u64(result + MULTICALL_WORD, 2 * MULTICALL_WORD);
+        bebi32_set_u64(result + 2 * MULTICALL_WORD, return_data_len);
+        uint8_t *data = result + MULTICALL_RESULT_HEADER;
+        if (return_data_len > 0) {
+            read_return_data(data, 0, return_data_len);
+        }
+        memset(data + return_data_len, 0, padded - return_data_len);
+        tail += MULTICALL_RESULT_HEADER + padded;
+    }
+    *out_len_out = tail;
+    return 0;
+}
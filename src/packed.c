@@ -0,0 +1,137 @@
+#include <packed.h>
+#include <string.h>
+#include <bebi.h>
+
+void packed_reader_init(packed_reader *reader, const uint8_t *data, size_t len) {
+    reader->data = data;
+    reader->len = len;
+    reader->pos = 0;
+    reader->error = false;
+}
+
+// reserves the next len bytes, or sets the error
+static const uint8_t *take(packed_reader *reader, size_t len) {
+    if (reader->error || len > reader->len - reader->pos) {
+        reader->error = true;
+        return NULL;
+    }
+    const uint8_t *res = reader->data + reader->pos;
+    reader->pos += len;
+    return res;
+}
+
+int packed_read_u8(packed_reader *reader, uint8_t *out) {
+    const uint8_t *src = take(reader, 1);
+    if (src == NULL) {
+        return -1;
+    }
+    *out = *src;
+    return 0;
+}
+
+int packed_read_varint(packed_reader *reader, uint64_t *out) {
+    if (reader->error) {
+        return -1;
+    }
+    uint64_t val = 0;
+    size_t pos = reader->pos;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (pos >= reader->len) {
+            break;
+        }
+        uint8_t byte = reader->data[pos++];
+        uint64_t bits = byte & 0x7f;
+        // the 10th byte may only hold the top bit of a u64
+        if (shift == 63 && bits > 1) {
+            break;
+        }
+        val |= bits << shift;
+        if ((byte & 0x80) == 0) {
+            reader->pos = pos;
+            *out = val;
+            return 0;
+        }
+    }
+    reader->error = true;
+    return -1;
+}
+
+int packed_read_address(packed_reader *reader, bebi32 out) {
+    const uint8_t *src = take(reader, 20);
+    if (src == NULL) {
+        return -1;
+    }
+    memset(out, 0, 12);
+    memcpy(out + 12, src, 20);
+    return 0;
+}
+
+int packed_read_uint(packed_reader *reader, bebi32 out) {
+    uint8_t len;
+    if (packed_read_u8(reader, &len) != 0) {
+        return -1;
+    }
+    if (len > 32) {
+        reader->error = true;
+        return -1;
+    }
+    const uint8_t *src = take(reader, len);
+    if (src == NULL) {
+        return -1;
+    }
+    memset(out, 0, 32 - len);
+    memcpy(out + 32 - len, src, len);
+    return 0;
+}
+
+int packed_read_bytes(packed_reader *reader, size_t len, const uint8_t **out) {
+    const uint8_t *src = take(reader, len);
+    if (src == NULL) {
+        return -1;
+    }
+    *out = src;
+    return 0;
+}
+
+int packed_end(const packed_reader *reader) {
+    if (reader->error || reader->pos != reader->len) {
+        return -1;
+    }
+    return 0;
+}
+
+size_t packed_write_varint(uint8_t *out, uint64_t val) {
+    size_t len = 0;
+    while (val >= 0x80) {
+        out[len++] = (uint8_t)(val | 0x80);
+        val >>= 7;
+    }
+    out[len++] = (uint8_t)val;
+    return len;
+}
+
+size_t packed_write_address(uint8_t *out, const uint8_t *address) {
+    memcpy(out, address, 20);
+    return 20;
+}
+
+size_t packed_write_uint(uint8_t *out, bebi32 const val) {
+    size_t skip = 0;
+    while (skip < 32 && val[skip] == 0) {
+        skip++;
+    }
+    out[0] = (uint8_t)(32 - skip);
+    memcpy(out + 1, val + skip, 32 - skip);
+    return 1 + 32 - skip;
+}
+
+ArbResult packed_dispatch(void *storage, const packed_handler *handlers, size_t count, const uint8_t *args,
+                          size_t len) {
+    if (len == 0 || args[0] >= count) {
+        ArbResult res = {Failure, NULL, 0};
+        return res;
+    }
+    packed_reader reader;
+    packed_reader_init(&reader, args + 1, len - 1);
+    return handlers[args[0]](storage, &reader);
+}
@@ -0,0 +1,56 @@
+// measuring calls must not be counted when tracing as well, see stylus_trace.h
+#define STYLUS_TRACE_IMPL
+#include <stylus_profile.h>
+
+#ifdef STYLUS_PROFILE
+
+#include <hostio.h>
+#include <stylus_debug.h>
+
+static stylus_profile_region *regions[STYLUS_PROFILE_MAX_REGIONS];
+static size_t region_count;
+
+// ink of one evm_ink_left, measured on first use
+static uint64_t overhead;
+static bool overhead_known;
+
+void stylus_profile_reset() {
+    for (size_t i = 0; i < region_count; i++) {
+        regions[i]->calls = 0;
+        regions[i]->ink = 0;
+    }
+}
+
+uint64_t stylus_profile_start() {
+    if (!overhead_known) {
+        uint64_t before = evm_ink_left();
+        overhead = before - evm_ink_left();
+        overhead_known = true;
+    }
+    return evm_ink_left();
+}
+
+void stylus_profile_end(stylus_profile_region *region, uint64_t start) {
+    uint64_t used = start - evm_ink_left();
+    region->calls++;
+    region->ink += used > overhead ? used - overhead : 0;
+    if (!region->registered && region_count < STYLUS_PROFILE_MAX_REGIONS) {
+        regions[region_count++] = region;
+        region->registered = true;
+    }
+}
+
+void stylus_profile_dump() {
+    for (size_t i = 0; i < region_count; i++) {
+        const char *name = regions[i]->name;
+        size_t len = 0;
+        while (name[len]) {
+            len++;
+        }
+        log_txt((const uint8_t *)name, len);
+        log_i64(regions[i]->calls);
+        log_i64(regions[i]->ink);
+    }
+}
+
+#endif // STYLUS_PROFILE
@@ -0,0 +1,55 @@
+#include <proxy.h>
+#include <hostio.h>
+#include <selectors.h>
+#include <string.h>
+#include <stdlib.h>
+#include <bebi.h>
+
+static const bebi32 implementation_slot = PROXY_IMPLEMENTATION_SLOT;
+static const bebi32 upgraded_topic = TOPIC_Upgraded;
+
+bool proxy_implementation(uint8_t *implementation) {
+    bebi32 value;
+    storage_load_bytes32(implementation_slot, value);
+    memcpy(implementation, value + 12, 20);
+    return !bebi32_is_zero(value);
+}
+
+void proxy_set_implementation(const uint8_t *implementation) {
+    // topics: Upgraded, indexed implementation. No data.
+    uint8_t log[64];
+    memcpy(log, upgraded_topic, 32);
+    memset(log + 32, 0, 12);
+    memcpy(log + 44, implementation, 20);
+    storage_store_bytes32(implementation_slot, log + 32);
+    emit_log(log, 64, 2);
+}
+
+// return data larger than args gets a heap buffer of its own: the stack is too small
+// for lengths chosen by the implementation
+static void write_return_data_copy(size_t return_data_len) {
+    uint8_t *data = malloc(return_data_len);
+    read_return_data(data, 0, return_data_len);
+    write_result(data, return_data_len);
+    free(data);
+}
+
+int proxy_forward(uint8_t *args, size_t args_len, proxy_init_handler init_main) {
+    uint8_t implementation[20];
+    if (!proxy_implementation(implementation)) {
+        const ArbResult result = init_main(args, args_len);
+        write_result(result.output, result.output_len);
+        return result.status;
+    }
+    size_t return_data_len = 0;
+    uint8_t status = delegate_call_contract(implementation, args, args_len, UINT64_MAX, &return_data_len);
+    if (return_data_len <= args_len) {
+        if (return_data_len > 0) {
+            read_return_data(args, 0, return_data_len);
+        }
+        write_result(args, return_data_len);
+    } else {
+        write_return_data_copy(return_data_len);
+    }
+    return status == 0 ? Success : Failure;
+}
@@ -0,0 +1,59 @@
+#include <reentrancy.h>
+#include <hostio.h>
+#include <string.h>
+#include <bebi.h>
+
+extern inline const uint8_t *reentrancy_slot(const reentrancy_guard *guard);
+
+int reentrancy_enter(reentrancy_guard *guard) {
+    storage_load_bytes32(guard->slot, guard->value);
+    guard->locked_in_storage = false;
+    if (bebi_get_u8(guard->value, guard->flag_offset) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+// reloads the slot, so writes made since entry (by the handler, or by the callee of a
+// delegate call) are kept, and stores it with the flag set to "flag"
+static void store_flag(reentrancy_guard *guard, uint8_t flag) {
+    storage_load_bytes32(guard->slot, guard->value);
+    bebi_set_u8(guard->value, guard->flag_offset, flag);
+    storage_store_bytes32(guard->slot, guard->value);
+}
+
+void reentrancy_call_begin(reentrancy_guard *guard) {
+    if (guard->locked_in_storage) {
+        return;
+    }
+    store_flag(guard, 1);
+    guard->locked_in_storage = true;
+}
+
+void reentrancy_exit(reentrancy_guard *guard) {
+    if (!guard->locked_in_storage) {
+        return;
+    }
+    store_flag(guard, 0);
+    guard->locked_in_storage = false;
+}
+
+void reentrancy_store_slot(reentrancy_guard *guard, bebi32 const value) {
+    bebi32 current;
+    storage_load_bytes32(guard->slot, current);
+    memcpy(guard->value, value, 32);
+    bebi_set_u8(guard->value, guard->flag_offset, bebi_get_u8(current, guard->flag_offset));
+    storage_store_bytes32(guard->slot, guard->value);
+}
+
+uint8_t reentrancy_call_contract(reentrancy_guard *guard, const uint8_t *contract, const uint8_t *calldata,
+                                 size_t calldata_len, const uint8_t *value, uint64_t gas, size_t *return_data_len) {
+    reentrancy_call_begin(guard);
+    return call_contract(contract, calldata, calldata_len, value, gas, return_data_len);
+}
+
+uint8_t reentrancy_delegate_call_contract(reentrancy_guard *guard, const uint8_t *contract, const uint8_t *calldata,
+                                          size_t calldata_len, uint64_t gas, size_t *return_data_len) {
+    reentrancy_call_begin(guard);
+    return delegate_call_contract(contract, calldata, calldata_len, gas, return_data_len);
+}
@@ -3,6 +3,17 @@
 extern inline void *memcpy(void *destination, const void *source, size_t num);
 extern inline void *memset(void *ptr, int value, size_t num);
 
+int memcmp(const void *ptr1, const void *ptr2, size_t num) {
+    const uint8_t *a = ptr1;
+    const uint8_t *b = ptr2;
+    for (size_t idx=0; idx<num; idx++) {
+        if (a[idx] != b[idx]) {
+            return a[idx] < b[idx] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
 char *strncpy(char *dst, const char *src, size_t num) {
     size_t idx=0;
     while (idx<num && src[idx]!=0) {
@@ -1,6 +1,12 @@
 #include <hostio.h>
 #include <string.h>
 #include <bebi.h>
+#include <keccak.h>
+#include <storage.h>
+#include "heapsort.h"
+
+extern inline void storage_load(const void* storage, const uint8_t *key, uint8_t *dest);
+extern inline void storage_store(void *storage, const uint8_t *key, const uint8_t *value);
 
 int array_slot_offset(bebi32 const base, size_t val_size, uint64_t index, bebi32 slot_out, size_t *offset_out) {
     uint64_t slots;
@@ -25,13 +31,179 @@ int array_slot_offset(bebi32 const base, size_t val_size, uint64_t index, bebi32
 }
 
 void dynamic_array_base_slot(bebi32 const storage, bebi32 base_out) {
-    native_keccak256(storage, 32, base_out);
+    keccak256(storage, 32, base_out);
+}
+
+static void hash_key_slot(keccak256_hasher *hasher, bebi32 const storage, uint8_t const *key, size_t key_len,
+                          bebi32 slot_out) {
+    keccak256_update(hasher, key, key_len);
+    keccak256_update(hasher, storage, 32);
+    keccak256_final(hasher, slot_out);
 }
 
 void map_slot(bebi32 const storage, uint8_t const *key, size_t key_len, bebi32 slot_out) {
-    uint8_t buf[32 + key_len];
-    memcpy(buf, key, key_len);
-    memcpy(buf+key_len, storage, 32);
-    native_keccak256(buf, 32 + key_len, slot_out);
+    keccak256_hasher hasher;
+    size_t len = key_len + 32;
+    if (keccak256_in_wasm(len)) {
+        // absorbed straight from key and storage
+        keccak256_init(&hasher, len, NULL, 0);
+        hash_key_slot(&hasher, storage, key, key_len, slot_out);
+    } else if (key_len <= 32) {
+        // the hostio hashes one buffer
+        uint8_t buf[64];
+        keccak256_init(&hasher, len, buf, sizeof(buf));
+        hash_key_slot(&hasher, storage, key, key_len, slot_out);
+    } else {
+        uint8_t buf[len];
+        keccak256_init(&hasher, len, buf, len);
+        hash_key_slot(&hasher, storage, key, key_len, slot_out);
+    }
+}
+
+
+void map_slot_path(bebi32 const base, uint8_t const *const keys[], size_t n, bebi32 slot_out) {
+    // key || slot, each hash overwrites the slot half in place
+    uint8_t buf[64];
+    memcpy(buf + 32, base, 32);
+    for (size_t i = 0; i < n; i++) {
+        memcpy(buf, keys[i], 32);
+        keccak256(buf, 64, buf + 32);
+    }
+    memcpy(slot_out, buf + 32, 32);
+}
+
+// slot of the bucket holding flags [bucket * 256, bucket * 256 + 256)
+static void bitmap_bucket_slot(bebi32 const base, uint64_t bucket, bebi32 slot_out) {
+    bebi32 key;
+    bebi32_set_u64(key, bucket);
+    map_slot(base, key, 32, slot_out);
+}
+
+static inline bool bit_get(bebi32 const word, unsigned bit) {
+    return (word[31 - (bit >> 3)] >> (bit & 7)) & 1;
+}
+
+// returns 1 if the bit changed
+static inline int bit_set_to(bebi32 word, unsigned bit, bool value) {
+    uint8_t mask = (uint8_t)(1 << (bit & 7));
+    uint8_t *byte = &word[31 - (bit >> 3)];
+    uint8_t next = value ? (*byte | mask) : (*byte & ~mask);
+    if (next == *byte) {
+        return 0;
+    }
+    *byte = next;
+    return 1;
+}
+
+void storage_bitmap_slot(bebi32 const base, uint64_t index, bebi32 slot_out) {
+    bitmap_bucket_slot(base, index >> 8, slot_out);
+}
+
+bool storage_bitmap_get(bebi32 const base, uint64_t index) {
+    bebi32 slot;
+    bebi32 word;
+    storage_bitmap_slot(base, index, slot);
+    storage_load_bytes32(slot, word);
+    return bit_get(word, index & 0xff);
+}
+
+int storage_bitmap_set_to(bebi32 const base, uint64_t index, bool value) {
+    bebi32 slot;
+    bebi32 word;
+    storage_bitmap_slot(base, index, slot);
+    storage_load_bytes32(slot, word);
+    if (!bit_set_to(word, index & 0xff, value)) {
+        return 0;
+    }
+    storage_store_bytes32(slot, word);
+    return 1;
+}
+
+int storage_bitmap_set(bebi32 const base, uint64_t index) {
+    return storage_bitmap_set_to(base, index, true);
+}
+
+int storage_bitmap_clear(bebi32 const base, uint64_t index) {
+    return storage_bitmap_set_to(base, index, false);
 }
 
+int storage_bitmap_set_range(bebi32 const base, uint64_t start, uint64_t count, bool value) {
+    if (count == 0) {
+        return 0;
+    }
+    if (count - 1 > UINT64_MAX - start) {
+        return -1;
+    }
+    uint64_t last = start + (count - 1);
+    for (uint64_t bucket = start >> 8; bucket <= last >> 8; bucket++) {
+        unsigned lo = bucket == start >> 8 ? start & 0xff : 0;
+        unsigned hi = bucket == last >> 8 ? last & 0xff : 0xff;
+        bebi32 slot;
+        bebi32 word;
+        bitmap_bucket_slot(base, bucket, slot);
+        if (lo == 0 && hi == 0xff) {
+            // the whole slot is overwritten, no need to load it
+            memset(word, value ? 0xff : 0, 32);
+            storage_store_bytes32(slot, word);
+            continue;
+        }
+        storage_load_bytes32(slot, word);
+        int changed = 0;
+        for (unsigned bit = lo; bit <= hi; bit++) {
+            changed |= bit_set_to(word, bit, value);
+        }
+        if (changed) {
+            storage_store_bytes32(slot, word);
+        }
+    }
+    return 0;
+}
+
+uint64_t storage_bitmap_count(bebi32 const base, uint64_t start, uint64_t count) {
+    if (count == 0) {
+        return 0;
+    }
+    // there are no flags past UINT64_MAX
+    uint64_t last = count - 1 > UINT64_MAX - start ? UINT64_MAX : start + (count - 1);
+    uint64_t total = 0;
+    for (uint64_t bucket = start >> 8; bucket <= last >> 8; bucket++) {
+        unsigned lo = bucket == start >> 8 ? start & 0xff : 0;
+        unsigned hi = bucket == last >> 8 ? last & 0xff : 0xff;
+        bebi32 slot;
+        bebi32 word;
+        bitmap_bucket_slot(base, bucket, slot);
+        storage_load_bytes32(slot, word);
+        for (unsigned bit = lo; bit <= hi; bit++) {
+            total += bit_get(word, bit);
+        }
+    }
+    return total;
+}
+
+static int u64_cmp(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+size_t storage_bitmap_set_batch(bebi32 const base, uint64_t *indexes, size_t n, bool value) {
+    heap_sort(indexes, n, sizeof(uint64_t), u64_cmp);
+    size_t changed = 0;
+    size_t i = 0;
+    while (i < n) {
+        uint64_t bucket = indexes[i] >> 8;
+        bebi32 slot;
+        bebi32 word;
+        bitmap_bucket_slot(base, bucket, slot);
+        storage_load_bytes32(slot, word);
+        size_t bucket_changed = 0;
+        for (; i < n && indexes[i] >> 8 == bucket; i++) {
+            bucket_changed += bit_set_to(word, indexes[i] & 0xff, value);
+        }
+        if (bucket_changed > 0) {
+            storage_store_bytes32(slot, word);
+        }
+        changed += bucket_changed;
+    }
+    return changed;
+}
@@ -0,0 +1,116 @@
+// the tracer calls the real hostios
+#define STYLUS_TRACE_IMPL
+#include <stylus_trace.h>
+
+#ifdef STYLUS_TRACE
+
+#include <stdbool.h>
+#include <string.h>
+#include <stylus_debug.h>
+
+uint32_t stylus_trace_calls[STYLUS_TRACE_HOSTIO_COUNT];
+uint64_t stylus_trace_ink[STYLUS_TRACE_HOSTIO_COUNT];
+
+#define STYLUS_TRACE_NAME(name) #name,
+static const char *const hostio_names[STYLUS_TRACE_HOSTIO_COUNT] = {
+    STYLUS_HOSTIOS(STYLUS_TRACE_NAME)
+};
+#undef STYLUS_TRACE_NAME
+
+// one mark per hostio being traced: a traced hostio may be evaluated in the arguments of
+// another (e.g. msg_sender while building storage_store_bytes32's value), and then nests
+typedef struct trace_mark {
+    uint64_t start;
+    // ink of nested traced hostios, attributed to them and not to this one
+    uint64_t nested;
+} trace_mark;
+
+static trace_mark marks[STYLUS_TRACE_MAX_DEPTH];
+static size_t depth;
+// ink of one evm_ink_left, measured on first use
+static uint64_t overhead;
+static bool overhead_known;
+
+void stylus_trace_reset() {
+    memset(stylus_trace_calls, 0, sizeof(stylus_trace_calls));
+    memset(stylus_trace_ink, 0, sizeof(stylus_trace_ink));
+    depth = 0;
+}
+
+void stylus_trace_begin() {
+    if (!overhead_known) {
+        uint64_t before = evm_ink_left();
+        overhead = before - evm_ink_left();
+        overhead_known = true;
+    }
+    if (depth < STYLUS_TRACE_MAX_DEPTH) {
+        marks[depth].start = evm_ink_left();
+        marks[depth].nested = 0;
+    }
+    depth++;
+}
+
+void stylus_trace_end(stylus_trace_hostio hostio) {
+    uint64_t now = evm_ink_left();
+    stylus_trace_calls[hostio]++;
+    depth--;
+    if (depth >= STYLUS_TRACE_MAX_DEPTH) {
+        // too deep to have a mark: counted, but no ink
+        return;
+    }
+    uint64_t total = marks[depth].start - now;
+    uint64_t used = total - marks[depth].nested;
+    stylus_trace_ink[hostio] += used > overhead ? used - overhead : 0;
+    if (depth > 0) {
+        // the enclosing hostio also paid for this one's evm_ink_left before the mark
+        marks[depth - 1].nested += total + overhead;
+    }
+}
+
+uint64_t stylus_trace_end_value(stylus_trace_hostio hostio, uint64_t value) {
+    stylus_trace_end(hostio);
+    return value;
+}
+
+static size_t append_str(char *buf, size_t pos, const char *str) {
+    while (*str) {
+        buf[pos++] = *str++;
+    }
+    return pos;
+}
+
+static size_t append_u64(char *buf, size_t pos, uint64_t val) {
+    char digits[20];
+    size_t len = 0;
+    do {
+        digits[len++] = '0' + (val % 10);
+        val /= 10;
+    } while (val);
+    while (len) {
+        buf[pos++] = digits[--len];
+    }
+    return pos;
+}
+
+void stylus_trace_dump() {
+    // longest name (22) + 2 x u64 (20) + separators
+    char line[96];
+    for (int hostio = 0; hostio < STYLUS_TRACE_HOSTIO_COUNT; hostio++) {
+        if (!stylus_trace_calls[hostio]) {
+            continue;
+        }
+        size_t pos = append_str(line, 0, "trace ");
+        pos = append_str(line, pos, hostio_names[hostio]);
+        pos = append_str(line, pos, ": ");
+        pos = append_u64(line, pos, stylus_trace_calls[hostio]);
+#ifdef STYLUS_TRACE_INK
+        pos = append_str(line, pos, " calls, ink ");
+        pos = append_u64(line, pos, stylus_trace_ink[hostio]);
+#else
+        pos = append_str(line, pos, " calls");
+#endif
+        log_txt((const uint8_t *)line, pos);
+    }
+}
+
+#endif // STYLUS_TRACE
@@ -1,6 +1,21 @@
 #include <stylus_utils.h>
 #include <bebi.h>
 #include <string.h>
+#include <selectors.h>
+#include <context.h>
+
+// the context cache lives here, with msg_sender_padded which reads it, so contracts that
+// link utils keep linking without another source file
+stylus_context_cache stylus_context;
+
+extern inline void context_reset();
+extern inline const uint8_t *context_msg_sender();
+extern inline const uint8_t *context_msg_value();
+extern inline const uint8_t *context_contract_address();
+extern inline const uint8_t *context_tx_origin();
+extern inline uint64_t context_block_timestamp();
+extern inline uint64_t context_block_number();
+extern inline uint64_t context_chainid();
 
 extern inline void msg_sender_padded(bebi sender);
 
@@ -20,7 +35,7 @@ ArbResult _return_short_string(ArbStatus status, char *string) {
     bebi32_set_u64(buf_out + 4, 32);
     if (status == Failure) {
         // Err encoding: ErrSignature
-        bebi_set_u32(buf_out, 0, 0x08c379a0);
+        bebi_set_u32(buf_out, 0, SELECTOR_Error);
         ArbResult res = {Failure, buf_out, 100};
         return res;
     }
@@ -0,0 +1,70 @@
+# Shared build settings for Stylus contracts that use this SDK.
+#
+# Set SDK_DIR to the root of the SDK and CONTRACT to the name of the wasm, then include this file:
+#     SDK_DIR=../..
+#     CONTRACT=erc20
+#     include $(SDK_DIR)/stylus.mk
+#
+# The contract's Makefile links $(BUILD_DIR)/$(CONTRACT).wasm from its objects, using
+# STYLUS_CC/STYLUS_CFLAGS and STYLUS_LD/STYLUS_LDFLAGS. This file provides the rest:
+#   $(BUILD_DIR)/lib/%.o       SDK sources, compiled for the selected profile
+#   $(BUILD_DIR)/%.opt.wasm    the linked wasm after the profile's post-link pass
+#   compare                    builds both profiles, and reports their size and instruction deltas
+#
+# Select a profile with PROFILE=<name>. Each profile builds in its own BUILD_DIR:
+#   default  every file compiled with -Os, linked with wasm-ld -O2
+#   lto      compiled with -flto: wasm-ld optimizes all objects as one, inlining across files
+#            and dropping unused code (--gc-sections), then wasm-opt $(WASM_OPT_FLAGS) runs
+#            on the result. Needs a wasm-opt (binaryen) in the path.
+
+# the including Makefile's first target stays the default goal
+STYLUS_MK_GOAL:=$(.DEFAULT_GOAL)
+
+STACK_SIZE?=8192
+PROFILE?=default
+BUILD_DIR=build/$(PROFILE)
+
+STYLUS_CC=clang
+STYLUS_LD=wasm-ld
+STYLUS_CFLAGS=-I$(SDK_DIR)/include/ --target=wasm32 -Os --no-standard-libraries -mbulk-memory -Wall -g
+STYLUS_LDFLAGS=-O2 --no-entry --stack-first -z stack-size=$(STACK_SIZE) -Bstatic
+
+WASM_OPT=wasm-opt
+# -Oz for size; -O3 trades some size for less ink
+WASM_OPT_FLAGS?=-Oz
+
+# "make SIZE_OPT=1" builds the size-optimized SDK variant, see STYLUS_SIZE_OPT in bebi.h
+ifdef SIZE_OPT
+STYLUS_CFLAGS+=-DSTYLUS_SIZE_OPT
+endif
+
+ifeq ($(PROFILE),lto)
+STYLUS_CFLAGS+=-flto
+STYLUS_LDFLAGS+=--lto-O2 --gc-sections
+else ifneq ($(PROFILE),default)
+$(error unknown PROFILE $(PROFILE), expected default or lto)
+endif
+
+$(BUILD_DIR)/lib/%.o: $(SDK_DIR)/src/%.c
+	mkdir -p $(BUILD_DIR)/lib
+	$(STYLUS_CC) $(STYLUS_CFLAGS) -c $< -o $@
+
+# -g keeps the name section, for the size report. wasm-strip removes it afterwards.
+ifeq ($(PROFILE),lto)
+$(BUILD_DIR)/%.opt.wasm: $(BUILD_DIR)/%.wasm
+	$(WASM_OPT) $(WASM_OPT_FLAGS) -g --enable-bulk-memory --enable-sign-ext $< -o $@
+else
+$(BUILD_DIR)/%.opt.wasm: $(BUILD_DIR)/%.wasm
+	cp $< $@
+endif
+
+# SCENARIO is an optional stylus_harness.js scenario file, whose calls are compared
+compare:
+	$(MAKE) PROFILE=default build/default/$(CONTRACT).opt.wasm
+	$(MAKE) PROFILE=lto build/lto/$(CONTRACT).opt.wasm
+	node $(SDK_DIR)/tools/compare_wasm.js build/default/$(CONTRACT).opt.wasm build/lto/$(CONTRACT).opt.wasm \
+		$(if $(SCENARIO),--scenario $(SCENARIO))
+
+.phony: compare
+
+.DEFAULT_GOAL:=$(STYLUS_MK_GOAL)
@@ -0,0 +1,86 @@
+#!/usr/bin/env node
+// Copyright 2022-2023, Offchain Labs, Inc.
+// For licensing, see https://github.com/OffchainLabs/stylus-sdk-c/blob/stylus/licenses/COPYRIGHT.md
+//
+// Compares two builds of the same contract, e.g. two build profiles (see stylus.mk):
+//  * stripped size, and size of the code section
+//  * wasm instructions executed by each call of a scenario, run in the local harness
+//
+// usage:
+//     node compare_wasm.js <base.wasm> <new.wasm> [--scenario file] [--json]
+//
+// The scenario file is the one of stylus_harness.js. Each build runs it on a fresh state.
+
+'use strict';
+
+const fs = require('fs');
+const { Harness, hexToBuffer } = require('./stylus_harness');
+const { report } = require('./wasm_size');
+
+function parseArgs(argv) {
+    const options = { wasms: [], json: false };
+    for (let i = 0; i < argv.length; i++) {
+        if (argv[i] === '--json') {
+            options.json = true;
+        } else if (argv[i] === '--scenario') {
+            options.scenario = argv[++i];
+        } else {
+            options.wasms.push(argv[i]);
+        }
+    }
+    return options;
+}
+
+function runScenario(wasmBytes, scenario) {
+    const harness = new Harness(wasmBytes, { sender: scenario.sender });
+    for (const [slot, value] of Object.entries(scenario.storage || {})) {
+        harness.setStorage(slot, value);
+    }
+    for (const [address, mock] of Object.entries(scenario.mocks || {})) {
+        harness.setMock(address, mock.status, mock.return);
+    }
+    return (scenario.calls || []).map((call, idx) => {
+        const result = harness.call(hexToBuffer(call.calldata), call);
+        return { name: call.name || `call ${idx}`, status: result.status, instructions: result.instructions };
+    });
+}
+
+function delta(base, next) {
+    const diff = next - base;
+    const pct = base ? ` (${diff >= 0 ? '+' : ''}${(100 * diff / base).toFixed(1)}%)` : '';
+    return `${diff >= 0 ? '+' : ''}${diff}${pct}`;
+}
+
+function main() {
+    const options = parseArgs(process.argv.slice(2));
+    if (options.wasms.length !== 2) {
+        process.stderr.write('usage: compare_wasm.js <base.wasm> <new.wasm> [--scenario file] [--json]\n');
+        process.exit(2);
+    }
+    const scenario = options.scenario ? JSON.parse(fs.readFileSync(options.scenario, 'utf8')) : { calls: [] };
+    const builds = options.wasms.map((file) => {
+        const bytes = fs.readFileSync(file);
+        const sizes = report(bytes, []);
+        return { file, stripped: sizes.stripped, code: sizes.sections.code || 0, calls: runScenario(bytes, scenario) };
+    });
+    const [base, next] = builds;
+
+    if (options.json) {
+        process.stdout.write(JSON.stringify({ base, new: next }, null, 2) + '\n');
+        return;
+    }
+    const row = (name, a, b) => process.stdout.write(`  ${name.padEnd(20)} ${String(a).padStart(10)} ${String(b).padStart(10)}  ${delta(a, b)}\n`);
+    process.stdout.write(`base: ${base.file}\nnew:  ${next.file}\n\n`);
+    process.stdout.write(`  ${''.padEnd(20)} ${'base'.padStart(10)} ${'new'.padStart(10)}  delta\n`);
+    row('stripped bytes', base.stripped, next.stripped);
+    row('code bytes', base.code, next.code);
+    base.calls.forEach((call, idx) => {
+        const other = next.calls[idx];
+        if (call.status !== other.status) {
+            process.stdout.write(`  ${call.name}: status differs (${call.status} vs ${other.status})\n`);
+        }
+        row(`${call.name} (instr)`, call.instructions, other.instructions);
+    });
+}
+
+main();
@@ -0,0 +1,81 @@
+// Copyright 2022-2023, Offchain Labs, Inc.
+// For licensing, see https://github.com/OffchainLabs/stylus-sdk-c/blob/stylus/licenses/COPYRIGHT.md
+//
+// keccak256 (not SHA3) for the SDK tools. Same algorithm as src/keccak.c, using BigInt lanes.
+
+'use strict';
+
+const MASK = (1n << 64n) - 1n;
+
+const ROUND_CONSTANTS = [
+    0x0000000000000001n, 0x0000000000008082n, 0x800000000000808an, 0x8000000080008000n,
+    0x000000000000808bn, 0x0000000080000001n, 0x8000000080008081n, 0x8000000000008009n,
+    0x000000000000008an, 0x0000000000000088n, 0x0000000080008009n, 0x000000008000000an,
+    0x000000008000808bn, 0x800000000000008bn, 0x8000000000008089n, 0x8000000000008003n,
+    0x8000000000008002n, 0x8000000000000080n, 0x000000000000800an, 0x800000008000000an,
+    0x8000000080008081n, 0x8000000000008080n, 0x0000000080000001n, 0x8000000080008008n,
+];
+
+const ROTATIONS = [1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44];
+const PI_LANES = [10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1];
+
+const RATE = 136;
+
+function rotl(x, b) {
+    return ((x << BigInt(b)) | (x >> BigInt(64 - b))) & MASK;
+}
+
+function keccakF1600(state) {
+    const bc = new Array(5);
+    for (let round = 0; round < 24; round++) {
+        for (let i = 0; i < 5; i++) {
+            bc[i] = state[i] ^ state[i + 5] ^ state[i + 10] ^ state[i + 15] ^ state[i + 20];
+        }
+        for (let i = 0; i < 5; i++) {
+            const t = bc[(i + 4) % 5] ^ rotl(bc[(i + 1) % 5], 1);
+            for (let j = 0; j < 25; j += 5) {
+                state[j + i] ^= t;
+            }
+        }
+        let t = state[1];
+        for (let i = 0; i < 24; i++) {
+            const j = PI_LANES[i];
+            const next = state[j];
+            state[j] = rotl(t, ROTATIONS[i]);
+            t = next;
+        }
+        for (let j = 0; j < 25; j += 5) {
+            for (let i = 0; i < 5; i++) {
+                bc[i] = state[j + i];
+            }
+            for (let i = 0; i < 5; i++) {
+                state[j + i] ^= (~bc[(i + 1) % 5] & MASK) & bc[(i + 2) % 5];
+            }
+        }
+        state[0] ^= ROUND_CONSTANTS[round];
+    }
+}
+
+// data: Uint8Array, Buffer or string (utf-8). Returns a 32-byte Buffer.
+function keccak256(data) {
+    const input = typeof data === 'string' ? Buffer.from(data, 'utf8') : Buffer.from(data);
+    const padded = Buffer.alloc((Math.floor(input.length / RATE) + 1) * RATE);
+    input.copy(padded);
+    padded[input.length] ^= 0x01;
+    padded[padded.length - 1] ^= 0x80;
+
+    const state = new Array(25).fill(0n);
+    for (let block = 0; block < padded.length; block += RATE) {
+        for (let lane = 0; lane < RATE / 8; lane++) {
+            state[lane] ^= padded.readBigUInt64LE(block + 8 * lane);
+        }
+        keccakF1600(state);
+    }
+    const out = Buffer.alloc(32);
+    for (let lane = 0; lane < 4; lane++) {
+        out.writeBigUInt64LE(state[lane], 8 * lane);
+    }
+    return out;
+}
+
+module.exports = { keccak256 };
@@ -0,0 +1,47 @@
+// Copyright 2022-2023, Offchain Labs, Inc.
+// For licensing, see https://github.com/OffchainLabs/stylus-sdk-c/blob/stylus/licenses/COPYRIGHT.md
+//
+// Encodes packed (non-ABI) calldata, as decoded by include/packed.h
+
+'use strict';
+
+function varint(value) {
+    let val = BigInt(value);
+    const bytes = [];
+    while (val >= 0x80n) {
+        bytes.push(Number(val & 0x7fn) | 0x80);
+        val >>= 7n;
+    }
+    bytes.push(Number(val));
+    return Buffer.from(bytes);
+}
+
+function address(hex) {
+    const digits = hex.replace(/^0x/, '').padStart(40, '0');
+    if (digits.length !== 40) {
+        throw new Error(`${hex} is not an address`);
+    }
+    return Buffer.from(digits, 'hex');
+}
+
+function uint(value) {
+    let val = BigInt(value);
+    const bytes = [];
+    while (val > 0n) {
+        bytes.unshift(Number(val & 0xffn));
+        val >>= 8n;
+    }
+    if (bytes.length > 32) {
+        throw new Error(`${value} does not fit 256 bits`);
+    }
+    return Buffer.from([bytes.length, ...bytes]);
+}
+
+/**
+ * a packed call: the method byte followed by the encoded fields
+ */
+function call(method, ...fields) {
+    return Buffer.concat([Buffer.from([method]), ...fields]);
+}
+
+module.exports = { varint, address, uint, call };
@@ -0,0 +1,471 @@
+// Copyright 2022-2023, Offchain Labs, Inc.
+// For licensing, see https://github.com/OffchainLabs/stylus-sdk-c/blob/stylus/licenses/COPYRIGHT.md
+//
+// Minimal wasm binary reader/writer for the SDK tools.
+// Supports the MVP, bulk-memory, sign-extension and simd128 instruction sets.
+
+'use strict';
+
+const SECTION = {
+    custom: 0, type: 1, import: 2, function: 3, table: 4, memory: 5, global: 6,
+    export: 7, start: 8, element: 9, code: 10, data: 11, datacount: 12,
+};
+
+class Reader {
+    constructor(buf, pos = 0) {
+        this.buf = buf;
+        this.pos = pos;
+    }
+
+    u8() {
+        return this.buf[this.pos++];
+    }
+
+    u32() {
+        let result = 0;
+        let shift = 0;
+        for (;;) {
+            const byte = this.buf[this.pos++];
+            result += (byte & 0x7f) * 2 ** shift;
+            shift += 7;
+            if ((byte & 0x80) === 0) {
+                return result;
+            }
+        }
+    }
+
+    // signed LEBs are only skipped, the tools never need their value
+    skipLeb() {
+        while (this.buf[this.pos++] & 0x80) {
+            // continue
+        }
+    }
+
+    bytes(len) {
+        const out = this.buf.subarray(this.pos, this.pos + len);
+        this.pos += len;
+        return out;
+    }
+
+    name() {
+        return Buffer.from(this.bytes(this.u32())).toString('utf8');
+    }
+}
+
+function encodeU32(value) {
+    const out = [];
+    do {
+        let byte = value & 0x7f;
+        value = Math.floor(value / 128);
+        if (value !== 0) {
+            byte |= 0x80;
+        }
+        out.push(byte);
+    } while (value !== 0);
+    return Buffer.from(out);
+}
+
+function encodeS64(value) {
+    let v = BigInt(value);
+    const out = [];
+    for (;;) {
+        const byte = Number(v & 0x7fn);
+        v >>= 7n;
+        if ((v === 0n && (byte & 0x40) === 0) || (v === -1n && (byte & 0x40) !== 0)) {
+            out.push(byte);
+            return Buffer.from(out);
+        }
+        out.push(byte | 0x80);
+    }
+}
+
+function encodeName(name) {
+    const bytes = Buffer.from(name, 'utf8');
+    return Buffer.concat([encodeU32(bytes.length), bytes]);
+}
+
+function encodeSection(id, contents) {
+    return Buffer.concat([Buffer.from([id]), encodeU32(contents.length), contents]);
+}
+
+function encodeVector(items) {
+    return Buffer.concat([encodeU32(items.length), ...items]);
+}
+
+/**
+ * returns [{id, name, start, end, contents}] where start/end bound the whole section
+ */
+function parseSections(buf) {
+    if (buf.readUInt32LE(0) !== 0x6d736100) {
+        throw new Error('not a wasm module');
+    }
+    const sections = [];
+    const reader = new Reader(buf, 8);
+    while (reader.pos < buf.length) {
+        const start = reader.pos;
+        const id = reader.u8();
+        const size = reader.u32();
+        const contentStart = reader.pos;
+        const section = { id, start, end: contentStart + size, contents: buf.subarray(contentStart, contentStart + size) };
+        if (id === SECTION.custom) {
+            section.name = new Reader(section.contents).name();
+        }
+        sections.push(section);
+        reader.pos = contentStart + size;
+    }
+    return sections;
+}
+
+function findSection(sections, id) {
+    return sections.find((section) => section.id === id);
+}
+
+/**
+ * counts imports by kind: {func, table, memory, global}
+ */
+function countImports(sections) {
+    const counts = { func: 0, table: 0, memory: 0, global: 0 };
+    const section = findSection(sections, SECTION.import);
+    if (!section) {
+        return counts;
+    }
+    const reader = new Reader(section.contents);
+    const count = reader.u32();
+    for (let i = 0; i < count; i++) {
+        reader.name();
+        reader.name();
+        const kind = reader.u8();
+        if (kind === 0) {
+            reader.u32();
+            counts.func++;
+        } else if (kind === 1) {
+            reader.u8();
+            skipLimits(reader);
+            counts.table++;
+        } else if (kind === 2) {
+            skipLimits(reader);
+            counts.memory++;
+        } else {
+            reader.u8();
+            reader.u8();
+            counts.global++;
+        }
+    }
+    return counts;
+}
+
+function skipLimits(reader) {
+    const flags = reader.u8();
+    reader.u32();
+    if (flags & 1) {
+        reader.u32();
+    }
+}
+
+function memarg(reader) {
+    reader.u32();
+    reader.u32();
+}
+
+function blocktype(reader) {
+    const byte = reader.buf[reader.pos];
+    if (byte === 0x40 || (byte >= 0x6f && byte <= 0x7f)) {
+        reader.pos++;
+    } else {
+        reader.skipLeb();
+    }
+}
+
+// skips the immediates of the 0xfc (bulk memory, saturating truncation) prefix
+function prefixFC(reader) {
+    const op = reader.u32();
+    if (op <= 7) {
+        return;
+    }
+    switch (op) {
+    case 8: reader.u32(); reader.u8(); return;
+    case 10: reader.u8(); reader.u8(); return;
+    case 11: reader.u8(); return;
+    case 12: case 14: reader.u32(); reader.u32(); return;
+    default: reader.u32(); return;
+    }
+}
+
+// skips the immediates of the 0xfd (simd128) prefix
+function prefixFD(reader) {
+    const op = reader.u32();
+    if (op <= 11 || op === 92 || op === 93) {
+        memarg(reader);
+    } else if (op === 12 || op === 13) {
+        reader.bytes(16);
+    } else if (op >= 21 && op <= 34) {
+        reader.u8();
+    } else if (op >= 84 && op <= 91) {
+        memarg(reader);
+        reader.u8();
+    }
+}
+
+/**
+ * decodes a single instruction at reader.pos, skipping its immediates. returns the opcode
+ */
+function skipInstruction(reader) {
+    const op = reader.u8();
+    switch (op) {
+    case 0x02: case 0x03: case 0x04:
+        blocktype(reader);
+        break;
+    case 0x0c: case 0x0d: case 0x10: case 0xd2:
+    case 0x20: case 0x21: case 0x22: case 0x23: case 0x24: case 0x25: case 0x26:
+        reader.u32();
+        break;
+    case 0x0e: {
+        const count = reader.u32();
+        for (let i = 0; i <= count; i++) {
+            reader.u32();
+        }
+        break;
+    }
+    case 0x11:
+        reader.u32();
+        reader.u32();
+        break;
+    case 0x1c:
+        reader.bytes(reader.u32());
+        break;
+    case 0x3f: case 0x40: case 0xd0:
+        reader.u8();
+        break;
+    case 0x41: case 0x42:
+        reader.skipLeb();
+        break;
+    case 0x43:
+        reader.bytes(4);
+        break;
+    case 0x44:
+        reader.bytes(8);
+        break;
+    case 0xfc:
+        prefixFC(reader);
+        break;
+    case 0xfd:
+        prefixFD(reader);
+        break;
+    default:
+        if (op >= 0x28 && op <= 0x3e) {
+            memarg(reader);
+        }
+    }
+    return op;
+}
+
+/**
+ * returns the function bodies of the code section: [{start, end, codeStart}]
+ * start/end bound the body (without its size), codeStart is where instructions begin
+ */
+function functionBodies(codeSection) {
+    const reader = new Reader(codeSection.contents);
+    const count = reader.u32();
+    const bodies = [];
+    for (let i = 0; i < count; i++) {
+        const size = reader.u32();
+        const start = reader.pos;
+        const groups = reader.u32();
+        for (let g = 0; g < groups; g++) {
+            reader.u32();
+            reader.u8();
+        }
+        bodies.push({ start, end: start + size, codeStart: reader.pos });
+        reader.pos = start + size;
+    }
+    return bodies;
+}
+
+/**
+ * returns the function names from the "name" custom section: Map(function index => name)
+ */
+function functionNames(sections) {
+    const names = new Map();
+    const section = sections.find((s) => s.id === SECTION.custom && s.name === 'name');
+    if (!section) {
+        return names;
+    }
+    const reader = new Reader(section.contents);
+    reader.name();
+    while (reader.pos < section.contents.length) {
+        const id = reader.u8();
+        const size = reader.u32();
+        const end = reader.pos + size;
+        if (id === 1) {
+            const count = reader.u32();
+            for (let i = 0; i < count; i++) {
+                const index = reader.u32();
+                names.set(index, reader.name());
+            }
+        }
+        reader.pos = end;
+    }
+    return names;
+}
+
+const SYMTAB = 8;
+const SYMBOL_KIND = { function: 0, data: 1, global: 2, section: 3, event: 4, table: 5 };
+const SYMBOL_UNDEFINED = 0x10;
+const SYMBOL_EXPLICIT_NAME = 0x40;
+
+/**
+ * returns the names of the functions defined by a relocatable object (clang -c output),
+ * from the symbol table of its "linking" custom section
+ */
+function definedFunctions(sections) {
+    const names = [];
+    const section = sections.find((s) => s.id === SECTION.custom && s.name === 'linking');
+    if (!section) {
+        return names;
+    }
+    const reader = new Reader(section.contents);
+    reader.name();
+    reader.u32(); // version
+    while (reader.pos < section.contents.length) {
+        const id = reader.u8();
+        const size = reader.u32();
+        const end = reader.pos + size;
+        if (id === SYMTAB) {
+            const count = reader.u32();
+            for (let i = 0; i < count; i++) {
+                const kind = reader.u8();
+                const flags = reader.u32();
+                const undefined = (flags & SYMBOL_UNDEFINED) !== 0;
+                if (kind === SYMBOL_KIND.data) {
+                    reader.name();
+                    if (!undefined) {
+                        reader.u32();
+                        reader.u32();
+                        reader.u32();
+                    }
+                } else if (kind === SYMBOL_KIND.section) {
+                    reader.u32();
+                } else {
+                    reader.u32();
+                    if (!undefined || (flags & SYMBOL_EXPLICIT_NAME)) {
+                        const name = reader.name();
+                        if (kind === SYMBOL_KIND.function && !undefined) {
+                            names.push(name);
+                        }
+                    }
+                }
+            }
+        }
+        reader.pos = end;
+    }
+    return names;
+}
+
+// instructions after which execution may not continue to the next instruction in order
+const BLOCK_BOUNDARIES = new Set([
+    0x00, 0x02, 0x03, 0x04, 0x05, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11,
+]);
+
+/**
+ * Adds an exported, mutable i64 global named exportName, and instruments every function so
+ * that the global counts the wasm instructions executed.
+ *
+ * Like the Stylus ink meter, a basic block adds its instruction count to the counter when it
+ * is entered. A block that traps midway is counted as a whole.
+ */
+function instrumentInstructionCount(buf, exportName) {
+    const sections = parseSections(buf);
+    const imports = countImports(sections);
+
+    const globalSection = findSection(sections, SECTION.global);
+    let globalEntries = [];
+    let definedGlobals = 0;
+    if (globalSection) {
+        const reader = new Reader(globalSection.contents);
+        definedGlobals = reader.u32();
+        globalEntries = [globalSection.contents.subarray(reader.pos)];
+    }
+    const counter = imports.global + definedGlobals;
+    const counterGlobal = Buffer.from([0x7e, 0x01, 0x42, 0x00, 0x0b]);
+    const newGlobalSection = encodeSection(SECTION.global, Buffer.concat([
+        encodeU32(definedGlobals + 1), ...globalEntries, counterGlobal,
+    ]));
+
+    const exportSection = findSection(sections, SECTION.export);
+    let exportEntries = [];
+    let exportCount = 0;
+    if (exportSection) {
+        const reader = new Reader(exportSection.contents);
+        exportCount = reader.u32();
+        exportEntries = [exportSection.contents.subarray(reader.pos)];
+    }
+    const newExportSection = encodeSection(SECTION.export, Buffer.concat([
+        encodeU32(exportCount + 1), ...exportEntries,
+        encodeName(exportName), Buffer.from([0x03]), encodeU32(counter),
+    ]));
+
+    const counterIdx = encodeU32(counter);
+    const charge = (count) => Buffer.concat([
+        Buffer.from([0x23]), counterIdx, Buffer.from([0x42]), encodeS64(count),
+        Buffer.from([0x7c, 0x24]), counterIdx,
+    ]);
+
+    const codeSection = findSection(sections, SECTION.code);
+    const bodies = functionBodies(codeSection).map((body) => {
+        const out = [codeSection.contents.subarray(body.start, body.codeStart)];
+        const reader = new Reader(codeSection.contents, body.codeStart);
+        let blockStart = reader.pos;
+        let count = 0;
+        while (reader.pos < body.end) {
+            const op = skipInstruction(reader);
+            count++;
+            if (BLOCK_BOUNDARIES.has(op)) {
+                out.push(charge(count), codeSection.contents.subarray(blockStart, reader.pos));
+                blockStart = reader.pos;
+                count = 0;
+            }
+        }
+        const encoded = Buffer.concat(out);
+        return Buffer.concat([encodeU32(encoded.length), encoded]);
+    });
+    const newCodeSection = encodeSection(SECTION.code, encodeVector(bodies));
+
+    const out = [buf.subarray(0, 8)];
+    let globalsWritten = false;
+    for (const section of sections) {
+        const raw = buf.subarray(section.start, section.end);
+        if (!globalsWritten && section.id !== SECTION.custom && section.id > SECTION.global && section.id !== SECTION.datacount) {
+            out.push(newGlobalSection);
+            globalsWritten = true;
+        }
+        if (section.id === SECTION.global) {
+            continue;
+        }
+        if (section.id === SECTION.export) {
+            out.push(newExportSection);
+        } else if (section.id === SECTION.code) {
+            if (!exportSection) {
+                // export section precedes start, element, datacount and code
+                out.splice(out.indexOf(newGlobalSection) + 1, 0, newExportSection);
+            }
+            out.push(newCodeSection);
+        } else {
+            out.push(raw);
+        }
+    }
+    return Buffer.concat(out);
+}
+
+module.exports = {
+    SECTION,
+    Reader,
+    encodeU32,
+    parseSections,
+    findSection,
+    countImports,
+    functionBodies,
+    functionNames,
+    definedFunctions,
+    skipInstruction,
+    instrumentInstructionCount,
+};
@@ -0,0 +1,162 @@
+#!/usr/bin/env node
+// Copyright 2022-2023, Offchain Labs, Inc.
+// For licensing, see https://github.com/OffchainLabs/stylus-sdk-c/blob/stylus/licenses/COPYRIGHT.md
+//
+// Generates a C header with function selectors and event topics, so C contracts
+// need no magic constants and no runtime keccak for them.
+// (C++ contracts can compute the same values at compile time, see include/stylus/keccak.hpp)
+//
+// usage:
+//     node selectors.js [signature ...] [--abi <interface.json>] [--guard <name>] [--out <file.h>]
+//
+// signature:
+//     transfer(address,uint256)              a function
+//     event:Transfer(address,address,uint256) an event
+//     name=signature                         sets the name used in the defines
+// --abi reads every function and non-anonymous event of every contract in a solc
+// standard-json output, such as the build/interface.json of the examples.
+//
+// For a function "transfer" the header defines:
+//     SELECTOR_transfer        0xa9059cbb, compare with bebi_get_u32(input, 0)
+//     SELECTOR_BYTES_transfer  {0xa9, 0x05, 0x9c, 0xbb}
+// For an event "Transfer":
+//     TOPIC_Transfer           32-byte initializer of topic0
+// Overloaded names get their argument types appended, e.g. SELECTOR_safeTransferFrom_address_address_uint256.
+
+'use strict';
+
+const fs = require('fs');
+const { keccak256 } = require('./lib/keccak');
+
+function parseArgs(argv) {
+    const options = { entries: [], abi: [], guard: '__SELECTORS_H', out: null };
+    for (let i = 0; i < argv.length; i++) {
+        const arg = argv[i];
+        if (arg === '--abi') {
+            options.abi.push(argv[++i]);
+        } else if (arg === '--guard' || arg === '--out') {
+            options[arg.slice(2)] = argv[++i];
+        } else {
+            options.entries.push(parseEntry(arg));
+        }
+    }
+    return options;
+}
+
+function parseEntry(arg) {
+    let kind = 'function';
+    let name = null;
+    let signature = arg;
+    if (signature.startsWith('event:')) {
+        kind = 'event';
+        signature = signature.slice('event:'.length);
+    }
+    const eq = signature.indexOf('=');
+    if (eq >= 0) {
+        name = signature.slice(0, eq);
+        signature = signature.slice(eq + 1);
+    }
+    if (!/^[A-Za-z_$][A-Za-z0-9_$]*\([^ ]*\)$/.test(signature)) {
+        throw new Error(`not a canonical signature: ${signature}`);
+    }
+    return { kind, name, signature };
+}
+
+// canonical type of an abi parameter: tuples are expanded to their components
+function canonicalType(param) {
+    if (!param.type.startsWith('tuple')) {
+        return param.type;
+    }
+    const suffix = param.type.slice('tuple'.length);
+    return `(${param.components.map(canonicalType).join(',')})${suffix}`;
+}
+
+function abiEntries(file) {
+    const output = JSON.parse(fs.readFileSync(file, 'utf8'));
+    const entries = [];
+    for (const contracts of Object.values(output.contracts || {})) {
+        for (const contract of Object.values(contracts)) {
+            for (const item of contract.abi || []) {
+                if ((item.type !== 'function' && item.type !== 'event') || item.anonymous) {
+                    continue;
+                }
+                const signature = `${item.name}(${item.inputs.map(canonicalType).join(',')})`;
+                if (!entries.some((entry) => entry.kind === item.type && entry.signature === signature)) {
+                    entries.push({ kind: item.type, name: null, signature });
+                }
+            }
+        }
+    }
+    return entries;
+}
+
+function defineName(entry, overloaded) {
+    if (entry.name) {
+        return entry.name;
+    }
+    const base = entry.signature.slice(0, entry.signature.indexOf('('));
+    if (!overloaded) {
+        return base;
+    }
+    const types = entry.signature.slice(base.length).replace(/[^A-Za-z0-9]+/g, '_').replace(/^_|_$/g, '');
+    return types ? `${base}_${types}` : base;
+}
+
+function bytesInitializer(bytes) {
+    return `{${[...bytes].map((b) => '0x' + b.toString(16).padStart(2, '0')).join(', ')}}`;
+}
+
+function generate(entries, guard) {
+    const counts = {};
+    for (const entry of entries) {
+        const key = `${entry.kind}:${entry.signature.slice(0, entry.signature.indexOf('('))}`;
+        counts[key] = (counts[key] || 0) + (entry.name ? 0 : 1);
+    }
+    const lines = [
+        `// generated by tools/selectors.js, do not edit`,
+        ``,
+        `#ifndef ${guard}`,
+        `#define ${guard}`,
+        ``,
+    ];
+    const seen = new Set();
+    for (const entry of entries) {
+        const key = `${entry.kind}:${entry.signature.slice(0, entry.signature.indexOf('('))}`;
+        const name = defineName(entry, counts[key] > 1);
+        const hash = keccak256(Buffer.from(entry.signature, 'utf8'));
+        if (seen.has(`${entry.kind}:${name}`)) {
+            throw new Error(`duplicate name ${name}, use name=signature`);
+        }
+        seen.add(`${entry.kind}:${name}`);
+        lines.push(`// ${entry.signature}`);
+        if (entry.kind === 'event') {
+            lines.push(`#define TOPIC_${name} ${bytesInitializer(hash)}`);
+        } else {
+            lines.push(`#define SELECTOR_${name} 0x${hash.subarray(0, 4).toString('hex')}`);
+            lines.push(`#define SELECTOR_BYTES_${name} ${bytesInitializer(hash.subarray(0, 4))}`);
+        }
+    }
+    lines.push(``, `#endif // ${guard}`, ``);
+    return lines.join('\n');
+}
+
+function main() {
+    const options = parseArgs(process.argv.slice(2));
+    const entries = [...options.abi.flatMap(abiEntries), ...options.entries];
+    if (entries.length === 0) {
+        process.stderr.write('usage: selectors.js [signature ...] [--abi interface.json] [--guard name] [--out file.h]\n');
+        process.exit(2);
+    }
+    const header = generate(entries, options.guard);
+    if (options.out) {
+        fs.writeFileSync(options.out, header);
+    } else {
+        process.stdout.write(header);
+    }
+}
+
+module.exports = { generate, parseEntry, abiEntries };
+
+if (require.main === module) {
+    main();
+}
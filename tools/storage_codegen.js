@@ -0,0 +1,460 @@
+#!/usr/bin/env node
+// Copyright 2022-2023, Offchain Labs, Inc.
+// For licensing, see https://github.com/OffchainLabs/stylus-sdk-c/blob/stylus/licenses/COPYRIGHT.md
+//
+// Generates C load/store functions for the structs of a solc storage layout, so C contracts
+// read and write whole structs instead of hand-coding every packed field.
+//
+// usage:
+//     node storage_codegen.js <interface.json> --out <dir/name> [--guard <name>]
+//
+// <interface.json> is solc standard-json output with "storageLayout" selected, such as the
+// build/interface.json of the examples. Writes <dir/name>.h and <dir/name>.c.
+//
+// For a struct "Position" of contract "Pool" the header defines:
+//     Pool_Position              the struct with native C fields
+//     Pool_Position_SLOTS        number of slots the struct covers
+//     Pool_Position_SLOT_<field> slot of a field relative to the struct, e.g. for mapping fields
+//     Pool_Position_slots        the covering slots as last loaded or stored
+//     Pool_Position_load(slot, value, raw)
+//     Pool_Position_store(slot, value, raw)
+// load reads every covering slot that holds a value field once. store packs the fields and
+// stores only the slots that differ from raw.
+//
+// Field types: bool, uintN/intN (N <= 64) as the smallest C integer holding them, enums as
+// unsigned integers, nested structs, fixed-size arrays, and anything else held in place
+// (address, bytesN, uint256...) as big-endian uint8_t[size]. Mappings, dynamic arrays, bytes
+// and string fields have no value of their own: they are left out of the C struct and
+// only get a _SLOT_ define.
+
+'use strict';
+
+const fs = require('fs');
+const path = require('path');
+
+function parseArgs(argv) {
+    const options = { input: null, out: null, guard: null };
+    for (let i = 0; i < argv.length; i++) {
+        const arg = argv[i];
+        if (arg === '--out' || arg === '--guard') {
+            options[arg.slice(2)] = argv[++i];
+        } else {
+            options.input = arg;
+        }
+    }
+    return options;
+}
+
+function cIdent(label) {
+    return label.replace(/[^A-Za-z0-9_]/g, '_');
+}
+
+// all types of all contracts, by solc type id
+function layoutTypes(output) {
+    const types = {};
+    for (const contracts of Object.values(output.contracts || {})) {
+        for (const contract of Object.values(contracts)) {
+            const layout = contract.storageLayout;
+            if (layout && layout.types) {
+                Object.assign(types, layout.types);
+            }
+        }
+    }
+    return types;
+}
+
+class Codegen {
+    constructor(types) {
+        this.types = types;
+        this.names = {};
+        this.helpers = new Set();
+        for (const [id, type] of Object.entries(types)) {
+            if (type.encoding === 'inplace' && type.members) {
+                const name = cIdent(type.label.replace(/^struct /, ''));
+                if (Object.values(this.names).includes(name)) {
+                    throw new Error(`duplicate struct name ${name}`);
+                }
+                this.names[id] = name;
+            }
+        }
+    }
+
+    type(id) {
+        const type = this.types[id];
+        if (!type) {
+            throw new Error(`type ${id} missing from storage layout`);
+        }
+        return type;
+    }
+
+    size(id) {
+        return Number(this.type(id).numberOfBytes);
+    }
+
+    // kind of a type held in place: struct, array, bool, uint, int or bytes
+    kind(id) {
+        const type = this.type(id);
+        if (type.encoding !== 'inplace') {
+            return null;
+        }
+        if (type.members) {
+            return 'struct';
+        }
+        if (type.base) {
+            return 'array';
+        }
+        const size = this.size(id);
+        if (type.label === 'bool') {
+            return 'bool';
+        }
+        if (size <= 8 && (/^uint\d*$/.test(type.label) || type.label.startsWith('enum '))) {
+            return 'uint';
+        }
+        if (size <= 8 && /^int\d*$/.test(type.label)) {
+            return 'int';
+        }
+        return 'bytes';
+    }
+
+    arrayLength(id) {
+        const match = /\)(\d+)_storage$/.exec(id);
+        if (!match) {
+            throw new Error(`unsupported array type ${id}`);
+        }
+        return Number(match[1]);
+    }
+
+    // array elements packed in one slot (0 if elements start their own slots)
+    perSlot(baseId) {
+        const kind = this.kind(baseId);
+        return kind === 'struct' || kind === 'array' ? 0 : Math.floor(32 / this.size(baseId));
+    }
+
+    // C declaration of a field, e.g. "uint8_t owner[20]"
+    declaration(id, name) {
+        const kind = this.kind(id);
+        const size = this.size(id);
+        if (kind === 'struct') {
+            return `${this.names[id]} ${name}`;
+        }
+        if (kind === 'array') {
+            return this.declaration(this.type(id).base, `${name}[${this.arrayLength(id)}]`);
+        }
+        if (kind === 'bool') {
+            return `bool ${name}`;
+        }
+        if (kind === 'uint' || kind === 'int') {
+            const bits = size <= 1 ? 8 : size <= 2 ? 16 : size <= 4 ? 32 : 64;
+            return `${kind === 'int' ? '' : 'u'}int${bits}_t ${name}`;
+        }
+        return `uint8_t ${name}[${size}]`;
+    }
+
+    // slots relative to the start of a type that hold value fields
+    valueSlots(id, base = 0, out = new Set()) {
+        const kind = this.kind(id);
+        if (kind === 'struct') {
+            for (const member of this.type(id).members) {
+                this.valueSlots(member.type, base + Number(member.slot), out);
+            }
+        } else if (kind === 'array') {
+            const baseId = this.type(id).base;
+            const length = this.arrayLength(id);
+            const perSlot = this.perSlot(baseId);
+            if (perSlot > 0) {
+                for (let i = 0; i < Math.ceil(length / perSlot); i++) {
+                    out.add(base + i);
+                }
+            } else {
+                const elementSlots = this.size(baseId) / 32;
+                for (let i = 0; i < length; i++) {
+                    this.valueSlots(baseId, base + i * elementSlots, out);
+                }
+            }
+        } else if (kind !== null) {
+            out.add(base);
+        }
+        return out;
+    }
+
+    // decode (or encode) the field of type id at slots[slot], offset bytes from the end of the slot
+    field(id, slot, offset, lvalue, encode, indent, depth = 0) {
+        const kind = this.kind(id);
+        const size = this.size(id);
+        const pad = ' '.repeat(indent);
+        if (kind === null) {
+            return [];
+        }
+        if (kind === 'struct') {
+            const name = this.names[id];
+            return encode
+                ? [`${pad}${name}_encode(&${lvalue}, slots + ${slot});`]
+                : [`${pad}${name}_decode(slots + ${slot}, &${lvalue});`];
+        }
+        if (kind === 'array') {
+            const baseId = this.type(id).base;
+            const i = `i${depth}`;
+            const perSlot = this.perSlot(baseId);
+            let elementSlot;
+            let elementOffset;
+            if (perSlot > 0) {
+                elementSlot = perSlot === 1 ? `${slot} + ${i}` : `${slot} + ${i} / ${perSlot}`;
+                elementOffset = perSlot === 1 ? '0' : `${i} % ${perSlot} * ${this.size(baseId)}`;
+            } else {
+                const elementSlots = this.size(baseId) / 32;
+                elementSlot = elementSlots === 1 ? `${slot} + ${i}` : `${slot} + ${i} * ${elementSlots}`;
+                elementOffset = '0';
+            }
+            return [
+                `${pad}for (size_t ${i} = 0; ${i} < ${this.arrayLength(id)}; ${i}++) {`,
+                ...this.field(baseId, elementSlot, elementOffset, `${lvalue}[${i}]`, encode, indent + 4, depth + 1),
+                `${pad}}`,
+            ];
+        }
+        const pos = /^\d+$/.test(offset) ? `${32 - Number(offset) - size}` : `${32 - size} - ${offset}`;
+        const bytes = pos === '0' ? `slots[${slot}]` : `slots[${slot}] + ${pos}`;
+        if (kind === 'bool') {
+            return encode
+                ? [`${pad}slots[${slot}][${pos}] = ${lvalue} ? 1 : 0;`]
+                : [`${pad}${lvalue} = slots[${slot}][${pos}] != 0;`];
+        }
+        if (kind === 'uint' || kind === 'int') {
+            if (encode) {
+                this.helpers.add('set');
+                return [`${pad}codec_set(${bytes}, ${size}, (uint64_t)${lvalue});`];
+            }
+            this.helpers.add(kind === 'int' ? 'get_signed' : 'get');
+            const cType = this.declaration(id, '').trim();
+            return [`${pad}${lvalue} = (${cType})codec_get${kind === 'int' ? '_signed' : ''}(${bytes}, ${size});`];
+        }
+        return encode
+            ? [`${pad}memcpy(${bytes}, ${lvalue}, ${size});`]
+            : [`${pad}memcpy(${lvalue}, ${bytes}, ${size});`];
+    }
+
+    // structs ordered so that nested structs come first
+    orderedStructs() {
+        const ordered = [];
+        const visit = (id) => {
+            if (ordered.includes(id)) {
+                return;
+            }
+            const kind = this.kind(id);
+            if (kind === 'struct') {
+                for (const member of this.type(id).members) {
+                    visit(member.type);
+                }
+                ordered.push(id);
+            } else if (kind === 'array') {
+                visit(this.type(id).base);
+            }
+        };
+        Object.keys(this.names).forEach(visit);
+        return ordered;
+    }
+
+    structHeader(id) {
+        const name = this.names[id];
+        const type = this.type(id);
+        const lines = [`// ${type.label}`, `#define ${name}_SLOTS ${this.size(id) / 32}`];
+        for (const member of type.members) {
+            lines.push(`#define ${name}_SLOT_${cIdent(member.label)} ${member.slot}`);
+        }
+        lines.push(``, `typedef struct ${name} {`);
+        for (const member of type.members) {
+            if (this.kind(member.type) === null) {
+                lines.push(`    // ${member.label}: ${this.type(member.type).label}, at ${name}_SLOT_${cIdent(member.label)}`);
+            } else {
+                lines.push(`    ${this.declaration(member.type, cIdent(member.label))};`);
+            }
+        }
+        lines.push(
+            `} ${name};`,
+            ``,
+            `typedef struct ${name}_slots {`,
+            `    bebi32 slot[${name}_SLOTS];`,
+            `} ${name}_slots;`,
+            ``,
+            `void ${name}_load(bebi32 const slot, ${name} *value, ${name}_slots *raw);`,
+            `void ${name}_store(bebi32 const slot, const ${name} *value, ${name}_slots *raw);`,
+            ``
+        );
+        return lines;
+    }
+
+    structSource(id) {
+        const name = this.names[id];
+        const type = this.type(id);
+        const decode = [];
+        const encode = [];
+        for (const member of type.members) {
+            const lvalue = `value->${cIdent(member.label)}`;
+            decode.push(...this.field(member.type, member.slot, `${member.offset}`, lvalue, false, 4));
+            encode.push(...this.field(member.type, member.slot, `${member.offset}`, lvalue, true, 4));
+        }
+        const valueSlots = [...this.valueSlots(id)].sort((a, b) => a - b);
+        const count = valueSlots.length;
+        const lines = [
+            `static void ${name}_decode(const bebi32 *slots, ${name} *value) {`,
+            ...decode,
+            `}`,
+            ``,
+            `static void ${name}_encode(const ${name} *value, bebi32 *slots) {`,
+            ...encode,
+            `}`,
+            ``,
+        ];
+        if (count > 0) {
+            lines.push(`// slots holding value fields`, `static const uint16_t ${name}_value_slots[] = {${valueSlots.join(', ')}};`, ``);
+        }
+        const load = count === 0 ? [] : [
+            `    for (size_t i = 0; i < ${count}; i++) {`,
+            `        bebi32 key;`,
+            `        memcpy(key, slot, 32);`,
+            `        bebi32_add_u64(key, ${name}_value_slots[i]);`,
+            `        storage_load_bytes32(key, raw->slot[${name}_value_slots[i]]);`,
+            `    }`,
+        ];
+        if (count > 0) {
+            this.helpers.add('equal');
+        }
+        const store = count === 0 ? [] : [
+            `    ${name}_slots next = *raw;`,
+            `    ${name}_encode(value, next.slot);`,
+            `    for (size_t i = 0; i < ${count}; i++) {`,
+            `        uint16_t idx = ${name}_value_slots[i];`,
+            `        if (!codec_equal(next.slot[idx], raw->slot[idx])) {`,
+            `            bebi32 key;`,
+            `            memcpy(key, slot, 32);`,
+            `            bebi32_add_u64(key, idx);`,
+            `            storage_store_bytes32(key, next.slot[idx]);`,
+            `            memcpy(raw->slot[idx], next.slot[idx], 32);`,
+            `        }`,
+            `    }`,
+        ];
+        lines.push(
+            `void ${name}_load(bebi32 const slot, ${name} *value, ${name}_slots *raw) {`,
+            `    memset(raw, 0, sizeof(*raw));`,
+            ...load,
+            `    ${name}_decode((const bebi32 *)raw->slot, value);`,
+            `}`,
+            ``,
+            `void ${name}_store(bebi32 const slot, const ${name} *value, ${name}_slots *raw) {`,
+            ...store,
+            `}`,
+            ``
+        );
+        return lines;
+    }
+
+    helperSource() {
+        const lines = [];
+        if (this.helpers.has('get') || this.helpers.has('get_signed')) {
+            lines.push(
+                `// big-endian integer of size bytes`,
+                `static uint64_t codec_get(const uint8_t *bytes, size_t size) {`,
+                `    uint64_t val = 0;`,
+                `    for (size_t i = 0; i < size; i++) {`,
+                `        val = (val << 8) | bytes[i];`,
+                `    }`,
+                `    return val;`,
+                `}`,
+                ``
+            );
+        }
+        if (this.helpers.has('get_signed')) {
+            lines.push(
+                `static int64_t codec_get_signed(const uint8_t *bytes, size_t size) {`,
+                `    unsigned shift = 64 - 8 * size;`,
+                `    return (int64_t)(codec_get(bytes, size) << shift) >> shift;`,
+                `}`,
+                ``
+            );
+        }
+        if (this.helpers.has('set')) {
+            lines.push(
+                `static void codec_set(uint8_t *bytes, size_t size, uint64_t val) {`,
+                `    for (size_t i = size; i > 0; i--) {`,
+                `        bytes[i - 1] = (uint8_t)val;`,
+                `        val >>= 8;`,
+                `    }`,
+                `}`,
+                ``
+            );
+        }
+        if (this.helpers.has('equal')) {
+            lines.push(
+                `// compares two slots without memcmp, so the codec links without simplelib`,
+                `static bool codec_equal(const uint8_t *a, const uint8_t *b) {`,
+                `    uint8_t diff = 0;`,
+                `    for (size_t i = 0; i < 32; i++) {`,
+                `        diff |= a[i] ^ b[i];`,
+                `    }`,
+                `    return diff == 0;`,
+                `}`,
+                ``
+            );
+        }
+        return lines;
+    }
+}
+
+function generate(output, baseName, guard) {
+    const codegen = new Codegen(layoutTypes(output));
+    const structs = codegen.orderedStructs();
+    const header = [
+        `// generated by tools/storage_codegen.js, do not edit`,
+        ``,
+        `#ifndef ${guard}`,
+        `#define ${guard}`,
+        ``,
+        `#include <stddef.h>`,
+        `#include <stdint.h>`,
+        `#include <stdbool.h>`,
+        `#include <bebi.h>`,
+        ``,
+        `#ifdef __cplusplus`,
+        `extern "C" {`,
+        `#endif`,
+        ``,
+        ...structs.flatMap((id) => codegen.structHeader(id)),
+        `#ifdef __cplusplus`,
+        `}`,
+        `#endif`,
+        ``,
+        `#endif // ${guard}`,
+        ``,
+    ];
+    const bodies = structs.flatMap((id) => codegen.structSource(id));
+    const source = [
+        `// generated by tools/storage_codegen.js, do not edit`,
+        ``,
+        `#include "${baseName}.h"`,
+        `#include <hostio.h>`,
+        `#include <string.h>`,
+        ``,
+        ...codegen.helperSource(),
+        ...bodies,
+    ];
+    return { header: header.join('\n'), source: source.join('\n') };
+}
+
+function main() {
+    const options = parseArgs(process.argv.slice(2));
+    if (!options.input || !options.out) {
+        process.stderr.write('usage: storage_codegen.js <interface.json> --out <dir/name> [--guard name]\n');
+        process.exit(2);
+    }
+    const output = JSON.parse(fs.readFileSync(options.input, 'utf8'));
+    const baseName = path.basename(options.out);
+    const guard = options.guard || `__${cIdent(baseName).toUpperCase()}_H`;
+    const { header, source } = generate(output, baseName, guard);
+    fs.writeFileSync(`${options.out}.h`, header);
+    fs.writeFileSync(`${options.out}.c`, source);
+}
+
+module.exports = { generate };
+
+if (require.main === module) {
+    main();
+}
@@ -0,0 +1,302 @@
+#!/usr/bin/env node
+// Copyright 2022-2023, Offchain Labs, Inc.
+// For licensing, see https://github.com/OffchainLabs/stylus-sdk-c/blob/stylus/licenses/COPYRIGHT.md
+//
+// Runs a Stylus wasm locally, with a stand-in host supplying the vm_hooks imports.
+// No node or network is needed. For each call it reports:
+//  * the status and return data
+//  * wasm instructions executed (the wasm is instrumented with a per-basic-block counter)
+//  * hostio calls by kind
+//  * memory pages at the end of the call
+//
+// usage:
+//     node stylus_harness.js <contract.wasm> [calldata ...] [options]
+//
+// options:
+//     --sender <address>     msg_sender for every call (default 0x...01)
+//     --value <hex>          msg_value for every call (default 0)
+//     --scenario <file>      json file with initial state and a list of calls, see below
+//     --json                 print the report as json
+//
+// scenario file:
+//     {
+//       "sender": "0x...",                       optional default sender
+//       "storage": { "<slot>": "<value>" },      optional initial storage
+//       "mocks": { "<address>": { "status": 0, "return": "0x..." } },
+//                                                optional results for calls to other contracts
+//       "calls": [ { "name": "...", "calldata": "0x...", "sender": "0x...", "value": "0x..." } ]
+//     }
+//
+// Every call runs in a fresh instance, as on-chain, but storage persists between calls.
+// A call that fails or traps rolls back its storage changes and logs.
+//
+// Requires node 16 or newer, and no packages.
+
+'use strict';
+
+const fs = require('fs');
+const { keccak256 } = require('./lib/keccak');
+const wasm = require('./lib/wasm');
+
+const COUNTER_EXPORT = '__stylus_harness_instructions';
+
+function hexToBuffer(hex, size) {
+    let digits = (hex || '').replace(/^0x/, '');
+    if (digits.length % 2) {
+        digits = '0' + digits;
+    }
+    const bytes = Buffer.from(digits, 'hex');
+    if (size === undefined || bytes.length === size) {
+        return bytes;
+    }
+    if (bytes.length > size) {
+        throw new Error(`${hex} is longer than ${size} bytes`);
+    }
+    return Buffer.concat([Buffer.alloc(size - bytes.length), bytes]);
+}
+
+function key(bytes) {
+    return Buffer.from(bytes).toString('hex');
+}
+
+class Harness {
+    /**
+     * wasmBytes: the contract, stripped or not
+     * env: defaults for calls: {sender, value, contract, origin, chainid, blockNumber, blockTimestamp}
+     */
+    constructor(wasmBytes, env = {}) {
+        this.module = new WebAssembly.Module(wasm.instrumentInstructionCount(Buffer.from(wasmBytes), COUNTER_EXPORT));
+        this.env = {
+            sender: hexToBuffer(env.sender || '0x01', 20),
+            value: hexToBuffer(env.value || '0x00', 32),
+            contract: hexToBuffer(env.contract || '0x05', 20),
+            origin: hexToBuffer(env.origin || env.sender || '0x01', 20),
+            chainid: BigInt(env.chainid || 412346),
+            blockNumber: BigInt(env.blockNumber || 1),
+            blockTimestamp: BigInt(env.blockTimestamp || 1700000000),
+            inkPrice: BigInt(env.inkPrice || 10000),
+        };
+        this.storage = new Map();
+        this.logs = [];
+        this.mocks = new Map();
+    }
+
+    setStorage(slot, value) {
+        this.storage.set(key(hexToBuffer(slot, 32)), hexToBuffer(value, 32));
+    }
+
+    setMock(address, status, returnData) {
+        this.mocks.set(key(hexToBuffer(address, 20)), { status, data: hexToBuffer(returnData || '0x') });
+    }
+
+    /**
+     * runs user_entrypoint with the given calldata. returns a report:
+     * {status, returnData, instructions, hostios, memoryPages, logs}
+     */
+    call(calldata, options = {}) {
+        const args = Buffer.from(calldata);
+        const sender = options.sender ? hexToBuffer(options.sender, 20) : this.env.sender;
+        const value = options.value ? hexToBuffer(options.value, 32) : this.env.value;
+        const hostios = {};
+        const journal = [];
+        const logsBefore = this.logs.length;
+        let result = Buffer.alloc(0);
+        let returnData = Buffer.alloc(0);
+        let instance;
+
+        const mem = () => new Uint8Array(instance.exports.memory.buffer);
+        const read = (ptr, len) => Buffer.from(mem().subarray(ptr, ptr + len));
+        const write = (ptr, bytes) => mem().set(bytes, ptr);
+        const instructions = () => instance.exports[COUNTER_EXPORT].value;
+
+        const subCall = (contract, calldataPtr, calldataLen, returnLenPtr) => {
+            const mock = this.mocks.get(key(read(contract, 20)));
+            returnData = mock ? mock.data : Buffer.alloc(0);
+            new DataView(instance.exports.memory.buffer).setUint32(returnLenPtr, returnData.length, true);
+            return mock ? mock.status : 1;
+        };
+
+        const hooks = {
+            account_balance: (address, dest) => write(dest, Buffer.alloc(32)),
+            account_codehash: (address, dest) => write(dest, Buffer.alloc(32)),
+            storage_load_bytes32: (slot, dest) => {
+                write(dest, this.storage.get(key(read(slot, 32))) || Buffer.alloc(32));
+            },
+            storage_store_bytes32: (slot, val) => {
+                const k = key(read(slot, 32));
+                journal.push([k, this.storage.get(k)]);
+                this.storage.set(k, read(val, 32));
+            },
+            block_basefee: (dest) => write(dest, Buffer.alloc(32)),
+            chainid: () => this.env.chainid,
+            block_coinbase: (dest) => write(dest, Buffer.alloc(20)),
+            block_gas_limit: () => 1125899906842624n,
+            block_number: () => this.env.blockNumber,
+            block_timestamp: () => this.env.blockTimestamp,
+            call_contract: (contract, calldataPtr, calldataLen, valuePtr, gas, returnLenPtr) =>
+                subCall(contract, calldataPtr, calldataLen, returnLenPtr),
+            contract_address: (dest) => write(dest, this.env.contract),
+            create1: (code, codeLen, endowment, contract, revertLenPtr) => {
+                write(contract, Buffer.alloc(20));
+                new DataView(instance.exports.memory.buffer).setUint32(revertLenPtr, 0, true);
+            },
+            create2: (code, codeLen, endowment, salt, contract, revertLenPtr) => {
+                write(contract, Buffer.alloc(20));
+                new DataView(instance.exports.memory.buffer).setUint32(revertLenPtr, 0, true);
+            },
+            delegate_call_contract: (contract, calldataPtr, calldataLen, gas, returnLenPtr) =>
+                subCall(contract, calldataPtr, calldataLen, returnLenPtr),
+            emit_log: (data, len, topics) => {
+                if (topics > 4 || len < topics * 32) {
+                    throw new Error('bad log');
+                }
+                this.logs.push({ data: read(data, len), topics });
+            },
+            evm_gas_left: () => hooks.evm_ink_left() / this.env.inkPrice,
+            // only wasm instructions are counted, at one ink each
+            evm_ink_left: () => BigInt(Number.MAX_SAFE_INTEGER) - instructions(),
+            memory_grow: () => {},
+            msg_sender: (dest) => write(dest, sender),
+            msg_value: (dest) => write(dest, value),
+            native_keccak256: (data, len, dest) => write(dest, keccak256(read(data, len))),
+            read_args: (dest) => write(dest, args),
+            read_return_data: (dest, offset, size) => {
+                if (offset > returnData.length) {
+                    throw new Error('read_return_data out of bounds');
+                }
+                const chunk = returnData.subarray(offset, offset + size);
+                write(dest, chunk);
+                return chunk.length;
+            },
+            write_result: (data, len) => {
+                result = read(data, len);
+            },
+            return_data_size: () => returnData.length,
+            static_call_contract: (contract, calldataPtr, calldataLen, gas, returnLenPtr) =>
+                subCall(contract, calldataPtr, calldataLen, returnLenPtr),
+            tx_gas_price: (dest) => write(dest, Buffer.alloc(32)),
+            tx_ink_price: () => this.env.inkPrice,
+            tx_origin: (dest) => write(dest, this.env.origin),
+        };
+
+        const counted = {};
+        for (const [name, fn] of Object.entries(hooks)) {
+            counted[name] = (...params) => {
+                hostios[name] = (hostios[name] || 0) + 1;
+                return fn(...params);
+            };
+        }
+        const consoleHooks = {};
+        for (const name of ['log_f32', 'log_f64', 'log_i32', 'log_i64']) {
+            consoleHooks[name] = (val) => process.stderr.write(`${name}: ${val}\n`);
+        }
+        consoleHooks.log_txt = (ptr, len) => process.stderr.write(`${read(ptr, len).toString('utf8')}\n`);
+
+        instance = new WebAssembly.Instance(this.module, { vm_hooks: counted, console: consoleHooks });
+        let status;
+        let trap = null;
+        try {
+            status = instance.exports.user_entrypoint(args.length);
+        } catch (err) {
+            status = 1;
+            trap = err.message;
+            result = Buffer.alloc(0);
+        }
+        if (status !== 0) {
+            for (const [k, prev] of journal.reverse()) {
+                if (prev === undefined) {
+                    this.storage.delete(k);
+                } else {
+                    this.storage.set(k, prev);
+                }
+            }
+            this.logs.length = logsBefore;
+        }
+        return {
+            status,
+            trap,
+            returnData: result,
+            instructions: Number(instructions()),
+            hostios,
+            memoryPages: instance.exports.memory.buffer.byteLength / 65536,
+            logs: this.logs.slice(logsBefore),
+        };
+    }
+}
+
+function parseArgs(argv) {
+    const options = { calls: [], json: false };
+    for (let i = 0; i < argv.length; i++) {
+        const arg = argv[i];
+        if (arg === '--json') {
+            options.json = true;
+        } else if (arg === '--sender' || arg === '--value' || arg === '--scenario') {
+            options[arg.slice(2)] = argv[++i];
+        } else if (options.wasm === undefined) {
+            options.wasm = arg;
+        } else {
+            options.calls.push({ calldata: arg });
+        }
+    }
+    return options;
+}
+
+function reportJson(name, report) {
+    return {
+        name,
+        status: report.status,
+        trap: report.trap,
+        return_data: '0x' + report.returnData.toString('hex'),
+        instructions: report.instructions,
+        hostios: report.hostios,
+        memory_pages: report.memoryPages,
+        logs: report.logs.length,
+    };
+}
+
+function main() {
+    const options = parseArgs(process.argv.slice(2));
+    if (!options.wasm) {
+        process.stderr.write('usage: stylus_harness.js <contract.wasm> [calldata ...] [--sender addr] [--value hex] [--scenario file] [--json]\n');
+        process.exit(2);
+    }
+    let scenario = { calls: [] };
+    if (options.scenario) {
+        scenario = JSON.parse(fs.readFileSync(options.scenario, 'utf8'));
+    }
+    const harness = new Harness(fs.readFileSync(options.wasm), {
+        sender: options.sender || scenario.sender,
+        value: options.value,
+    });
+    for (const [slot, value] of Object.entries(scenario.storage || {})) {
+        harness.setStorage(slot, value);
+    }
+    for (const [address, mock] of Object.entries(scenario.mocks || {})) {
+        harness.setMock(address, mock.status, mock.return);
+    }
+
+    const reports = [];
+    for (const [idx, call] of [...(scenario.calls || []), ...options.calls].entries()) {
+        const report = harness.call(hexToBuffer(call.calldata), call);
+        reports.push(reportJson(call.name || `call ${idx}`, report));
+    }
+    if (options.json) {
+        process.stdout.write(JSON.stringify(reports, null, 2) + '\n');
+        return;
+    }
+    for (const report of reports) {
+        process.stdout.write(`${report.name}: status ${report.status}${report.trap ? ` (trap: ${report.trap})` : ''}\n`);
+        process.stdout.write(`  return data:  ${report.return_data}\n`);
+        process.stdout.write(`  instructions: ${report.instructions}\n`);
+        process.stdout.write(`  memory pages: ${report.memory_pages}\n`);
+        for (const [name, count] of Object.entries(report.hostios)) {
+            process.stdout.write(`  ${name}: ${count}\n`);
+        }
+    }
+}
+
+module.exports = { Harness, hexToBuffer };
+
+if (require.main === module) {
+    main();
+}
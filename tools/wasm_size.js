@@ -0,0 +1,131 @@
+#!/usr/bin/env node
+// Copyright 2022-2023, Offchain Labs, Inc.
+// For licensing, see https://github.com/OffchainLabs/stylus-sdk-c/blob/stylus/licenses/COPYRIGHT.md
+//
+// Reports what a contract's wasm is made of, and checks it against a size budget.
+//  * the stripped size: what wasm-strip would leave, i.e. all but the custom sections
+//  * the size of each section
+//  * the size of each function body, grouped by the object file that defined it
+//
+// usage:
+//     node wasm_size.js <contract.wasm> [objects ...] [--budget <bytes>] [--top <n>] [--json]
+//
+// The wasm must be the unstripped link output, which keeps the "name" section.
+// Objects are the relocatable files passed to wasm-ld. Functions not defined by any of them
+// (e.g. compiler builtins), or by -flto objects, are grouped as "other". A function inlined into its callers
+// has no body of its own, so its bytes count towards the callers' objects.
+//
+// Exits with status 1 when the stripped size is larger than the budget.
+
+'use strict';
+
+const fs = require('fs');
+const path = require('path');
+const wasm = require('./lib/wasm');
+
+const LLVM_BITCODE = 0xdec04342;
+
+const SECTION_NAMES = Object.fromEntries(Object.entries(wasm.SECTION).map(([name, id]) => [id, name]));
+
+function parseArgs(argv) {
+    const options = { objects: [], budget: null, top: 20, json: false };
+    for (let i = 0; i < argv.length; i++) {
+        const arg = argv[i];
+        if (arg === '--json') {
+            options.json = true;
+        } else if (arg === '--budget' || arg === '--top') {
+            options[arg.slice(2)] = Number(argv[++i]);
+        } else if (options.wasm === undefined) {
+            options.wasm = arg;
+        } else {
+            options.objects.push(arg);
+        }
+    }
+    return options;
+}
+
+function report(wasmBytes, objects) {
+    const sections = wasm.parseSections(wasmBytes);
+    const names = wasm.functionNames(sections);
+    const imports = wasm.countImports(sections).func;
+
+    // later objects don't override earlier ones for the same (e.g. static) name
+    const owners = new Map();
+    for (const [file, bytes] of objects) {
+        const group = path.basename(file, '.o');
+        if (bytes.readUInt32LE(0) === LLVM_BITCODE) {
+            // -flto objects hold LLVM bitcode: their functions are reported as "other"
+            continue;
+        }
+        for (const name of wasm.definedFunctions(wasm.parseSections(bytes))) {
+            if (!owners.has(name)) {
+                owners.set(name, group);
+            }
+        }
+    }
+
+    const sectionSizes = {};
+    let stripped = 8;
+    for (const section of sections) {
+        const name = section.id === wasm.SECTION.custom ? `custom:${section.name}` : SECTION_NAMES[section.id];
+        sectionSizes[name] = (sectionSizes[name] || 0) + section.end - section.start;
+        if (section.id !== wasm.SECTION.custom) {
+            stripped += section.end - section.start;
+        }
+    }
+
+    const functions = [];
+    const groups = {};
+    const code = wasm.findSection(sections, wasm.SECTION.code);
+    if (code) {
+        wasm.functionBodies(code).forEach((body, idx) => {
+            const name = names.get(imports + idx) || `func[${imports + idx}]`;
+            // the body plus its size prefix
+            const size = body.end - body.start + wasm.encodeU32(body.end - body.start).length;
+            const group = owners.get(name) || 'other';
+            functions.push({ name, group, size });
+            groups[group] = (groups[group] || 0) + size;
+        });
+    }
+    functions.sort((a, b) => b.size - a.size);
+    return { stripped, sections: sectionSizes, groups, functions };
+}
+
+function main() {
+    const options = parseArgs(process.argv.slice(2));
+    if (!options.wasm) {
+        process.stderr.write('usage: wasm_size.js <contract.wasm> [objects ...] [--budget bytes] [--top n] [--json]\n');
+        process.exit(2);
+    }
+    const objects = options.objects.map((file) => [file, fs.readFileSync(file)]);
+    const result = report(fs.readFileSync(options.wasm), objects);
+    const overBudget = options.budget !== null && result.stripped > options.budget;
+
+    if (options.json) {
+        process.stdout.write(JSON.stringify({ ...result, budget: options.budget }, null, 2) + '\n');
+    } else {
+        const budget = options.budget !== null ? ` (budget ${options.budget})` : '';
+        process.stdout.write(`stripped size: ${result.stripped} bytes${budget}\n\nsections:\n`);
+        for (const [name, size] of Object.entries(result.sections)) {
+            process.stdout.write(`  ${name.padEnd(24)} ${size}\n`);
+        }
+        process.stdout.write('\ncode by object:\n');
+        for (const [group, size] of Object.entries(result.groups).sort((a, b) => b[1] - a[1])) {
+            process.stdout.write(`  ${group.padEnd(24)} ${size}\n`);
+        }
+        process.stdout.write(`\nlargest functions:\n`);
+        for (const fn of result.functions.slice(0, options.top)) {
+            process.stdout.write(`  ${fn.name.padEnd(40)} ${String(fn.size).padStart(6)}  ${fn.group}\n`);
+        }
+    }
+    if (overBudget) {
+        process.stderr.write(`${options.wasm}: ${result.stripped} bytes exceeds the budget of ${options.budget}\n`);
+        process.exit(1);
+    }
+}
+
+module.exports = { report };
+
+if (require.main === module) {
+    main();
+}